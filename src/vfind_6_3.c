@@ -0,0 +1,6862 @@
+/*******************************************************************************
+* vfind.c
+*	Search for files matching given criteria in a directory tree.
+*
+* Notes
+*	This program is intended for Microsoft Windows (Win32).
+*
+*	This file can be compiled using Microsoft C with the command:
+*	    cl vfind.c [-DDEBUG=1] [-I ..\include] [..\lib\]fpattern.obj vfind.res
+*
+*	Written in ISO C99 C with Microsoft variants.
+*
+*	Define "DEBUG=1" to compile with debug tracing messages.
+*
+* History
+*	2.0 1994-08-23, drt.
+*	Second edition.
+*
+*	2.1 1994-08-25, drt.
+*	Added the '-d', '-s', '-u', and '-g' options.
+*
+*	2.2 1994-08-25, drt.
+*	Added the '-t' option.
+*
+*	2.3 1994-09-13, drt.
+*	Added the '-?' option.
+*
+*	2.4 1995-01-08, drt.
+*	Show writable (non-read-only) permission as 'w'.
+*
+*	2.5 1995-05-09, drt.
+*	Uses '/' instead of '\' as path delimiter.
+*
+*	2.6 1995-07-01, drt.
+*	Go back (2.5) to using '\' (this is DOS after all).
+*
+*	3.0 1996-01-11, drt.
+*	Changed date/time format.
+*	Changed date output to show 'CCYY'.
+*
+*	3.50 1996-02-22, drt.
+*	Added support for Win32 long file names.
+*
+*	3.60 1996-12-31, drt.
+*	Added a block byte count.
+*	Added more '-t' options, and change exclusion rules.
+*	Added the '-A' option.
+*	Added the (undocumented) '-D' option.
+*
+*	3.70 1997-01-03, drt.
+*	Uses "fpattern.h" filename pattern matching functions.
+*	Added the '-n' summary option.
+*	Added the '-v' verbose option.
+*
+*	3.71 1997-01-13, drt.
+*	Uses fixed fpattern functions.
+*	Disabled Win32 long filename handling, since it doesn't work yet.
+*
+*	4.0 1997-01-26, drt.
+*	Fixed long filename handling.
+*	Added the '-m' short name option.
+*	Added the '-r' nonrecursive options.
+*
+*	4.1 1998-06-17, drt.
+*	Changed dates to be ISO-8601 format, "CCYY-MM-DD".
+*
+*	5.0, 2002-05-08, David R Tribble <david@tribble.com>.
+*	Converted from Win16 to Win32 compilation (uses <windows.h>).
+*	Changed tabs to be 8 spaces wide from 4 spaces wide.
+*	Added the '-w' option.
+*
+*	5.1, 2002-08-28, David R Tribble <david@tribble.com>.
+*	Fixed the '-tf' option.
+*
+*	5.2, 2002-11-15, David R Tribble <david@tribble.com>.
+*	Fixed the initialization of the search info structure in 'search()'.
+*
+*	5.3, 2008-09-03, David R Tribble <david@tribble.com>.
+*	Allowed multiple '-d' options.
+*
+*	5.4, 2011-03-13, David R Tribble <david@tribble.com>.
+*	Added the '-f' (file name only) option.
+*
+*	6.0, 2015-11-16, David R Tribble <david@tribble.com>.
+*	Changed the '-l' option to not display count totals.
+*	Allowed multiple '-s' options.
+*	Added 'k', 'm', and 'g' suffixes to the '-s' option.
+*	Added '-d' date comparison values of 'now' and 'today'.
+*	Added the '-z' (UTC timezone) option.
+*	Added more displayed file attributes.
+*
+*	6.1, 2015-12-17, David R Tribble <david@tribble.com>.
+*	Added more displayed file attributes (offline 'o').
+*	Eliminated redundant newlines output.
+*	Fixed some residual bugs.
+*
+*	6.2, 2016-01-18, David R Tribble <david@tribble.com>.
+*	Added '-d' date comparison values of 'yesterday' and 'tomorrow'.
+*
+*	6.3, 2026-10-19, David R Tribble <david@tribble.com>.
+*	Output is written by a separate thread through a ring of buffers.
+*	Added the '-F' (output format) option, with compact listing formats.
+*	Added the '-E' (expand listing) option.
+*	Added the '-F bin' binary listing format.
+*	Added the '-F json' listing format.
+*	Added the '-0' (null-terminated names) option.
+*	Added the '-j' (parallel search) and '-U' (unordered) options.
+*	Added the '-o' (sorted output) and '-M' (sort memory cap) options.
+*	Added the '-o dir' (sort within each directory) option.
+*	Added the '-top' (largest or newest entries) option.
+*	Added the '-du' (directory usage totals) option.
+*	Added the '-hist' (size and age histograms) option.
+*	Added the '-group' (group-by totals) option.
+*	Added the '-c' (count totals only) option.
+*	Count totals are 64-bit.
+*	Added the '-est' (estimated totals) option.
+*	Fixed the handling of a failed search in 'findfirst32()'.
+*	Added the '-max' (stop after N matches) and '-q' (quiet) options.
+*	The search stops when the output cannot be written (exit code 2).
+*	Added the '-x' (exclude directories) option.
+*	Added the '-maxdepth' and '-mindepth' (subdirectory depth) options.
+*	Wildcards are allowed in the directory prefix of a filename pattern.
+*	A '**' directory component matches any number of subdirectories.
+*	Added '{a,b}' (alternatives) to filename patterns.
+*	Added the '-prune-match' (do not search matching dirs) option.
+*	Added the '-ignore' (.gitignore and .vfindignore files) option.
+*	Directory links are not searched, unless '-follow' is specified.
+*
+* @(#)/drt/src/cmd/vfind.c $Revision: 6.3 $ $Date: 2026-10-19 $
+*
+* Copyright ©1994-2026 by David R. Tribble, all rights reserved.
+*/
+
+
+/*==============================================================================
+* Identification
+*/
+
+#define ID_C_TITLE	"vfind"
+#define ID_C_DATE	"2026-10-19"
+#define ID_C_VERS	"6.3"
+#define ID_C_AUTH	"David R. Tribble"
+#define ID_C_EMAIL	"<david@tribble.com>"
+#define ID_C_HOME	"<http://david.tribble.com>"
+#define ID_C_DIR	"/drt/src/cmd"
+#define ID_C_FILE	__FILE__
+#define ID_C_COMP	__DATE__ " " __TIME__
+
+static const char	COPYRIGHT[] =
+    "@(#)Copyright (c)1994-2026 by " ID_C_AUTH ", all rights reserved.";
+    /* Note: The copyright symbol '©' is '\251' */
+
+static const char	ID[] =
+    "@(#)$Header: " ID_C_DIR "/" ID_C_FILE " " ID_C_VERS " " ID_C_DATE " $";
+
+static const char	ID_BUILT[] =
+#if DEBUG-0 > 0
+    "@(#)$Built: " ID_C_COMP " +DEBUG $";
+#else
+    "@(#)$Built: " ID_C_COMP " $";
+#endif
+
+static const char	ID_AUTHOR[] =
+    "@(#)$Author: " ID_C_AUTH " " ID_C_EMAIL " $";
+
+static const char	ID_COMPILE[] =
+    "[" ID_C_TITLE ", " ID_C_VERS " " ID_C_DATE "] <" ID_C_COMP ">";
+
+static const char	ID_TITLE[] =	ID_C_TITLE;
+static const char	ID_DATE[] =	ID_C_DATE;
+static const char	ID_VERS[] =	ID_C_VERS;
+static const char	ID_AUTH[] =	ID_C_AUTH;
+static const char	ID_FILE[] =	ID_C_FILE;
+
+static const char *	prog = ID_TITLE;
+
+
+/*==============================================================================
+* System includes
+*/
+
+#include <ctype.h>
+#include <errno.h>
+#include <iso646.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <dos.h>
+#include <fcntl.h>
+#include <io.h>
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <sddl.h>
+
+#define TICKS_PER_DAY	(10000000LL*60*60*24)	/* 864,000,000,000	*/
+#define TICKS_PER_SEC	10000000LL
+#define TICKS_TO_1970	116444736000000000LL	/* 1601-01-01 to 1970-01-01 */
+
+/* Borrowed from "Microsoft SDKs\Windows\v7.0A\Include\WinNT.h" */
+#ifndef FILE_ATTRIBUTE_READONLY
+ #define FILE_ATTRIBUTE_READONLY	0x00000001
+#endif
+#ifndef FILE_ATTRIBUTE_HIDDEN
+ #define FILE_ATTRIBUTE_HIDDEN		0x00000002
+#endif
+#ifndef FILE_ATTRIBUTE_SYSTEM
+ #define FILE_ATTRIBUTE_SYSTEM		0x00000004
+#endif
+#ifndef FILE_ATTRIBUTE_DIRECTORY
+ #define FILE_ATTRIBUTE_DIRECTORY	0x00000010
+#endif
+#ifndef FILE_ATTRIBUTE_ARCHIVE
+ #define FILE_ATTRIBUTE_ARCHIVE		0x00000020
+#endif
+#ifndef FILE_ATTRIBUTE_DEVICE
+ #define FILE_ATTRIBUTE_DEVICE		0x00000040
+#endif
+#ifndef FILE_ATTRIBUTE_NORMAL
+ #define FILE_ATTRIBUTE_NORMAL		0x00000080
+#endif
+#ifndef FILE_ATTRIBUTE_TEMPORARY
+ #define FILE_ATTRIBUTE_TEMPORARY	0x00000100
+#endif
+#ifndef FILE_ATTRIBUTE_SPARSE_FILE
+ #define FILE_ATTRIBUTE_SPARSE_FILE	0x00000200
+#endif
+#ifndef FILE_ATTRIBUTE_REPARSE_POINT
+ #define FILE_ATTRIBUTE_REPARSE_POINT	0x00000400
+#endif
+#ifndef FILE_ATTRIBUTE_COMPRESSED
+ #define FILE_ATTRIBUTE_COMPRESSED	0x00000800
+#endif
+#ifndef FILE_ATTRIBUTE_OFFLINE
+ #define FILE_ATTRIBUTE_OFFLINE		0x00001000
+#endif
+#ifndef FILE_ATTRIBUTE_NOT_CONTENT_INDEXED
+ #define FILE_ATTRIBUTE_NOT_CONTENT_INDEXED	0x00002000
+#endif
+#ifndef FILE_ATTRIBUTE_ENCRYPTED
+ #define FILE_ATTRIBUTE_ENCRYPTED	0x00004000
+#endif
+#ifndef FILE_ATTRIBUTE_VIRTUAL
+ #define FILE_ATTRIBUTE_VIRTUAL		0x00010000
+#endif
+
+
+/*==============================================================================
+* Local includes
+*/
+
+#include "fpattern.h"
+
+
+/*==============================================================================
+* Manifest types and constants
+*/
+
+/* Boolean constants */
+#ifndef bool
+ #define bool		int
+#endif
+#ifndef false
+ #define false		0
+#endif
+#ifndef true
+ #define true		1
+#endif
+
+#ifndef uint64_t
+ typedef unsigned __int64	uint64_t;
+#endif
+
+/* Thread-local storage class */
+#ifdef _MSC_VER
+ #define THREAD_LOCAL	__declspec(thread)
+#else
+ #define THREAD_LOCAL	__thread
+#endif
+
+
+/* DOS/Win32 file attribute codes */
+#define A_NORMAL	FILE_ATTRIBUTE_NORMAL
+#define A_NORMAL2	0x00000000
+#define A_READONLY	FILE_ATTRIBUTE_READONLY
+#define A_HIDDEN	FILE_ATTRIBUTE_HIDDEN
+#define A_SYSTEM	FILE_ATTRIBUTE_SYSTEM
+#define A_VOLUME	0x00000008
+#define A_DIRECTORY	FILE_ATTRIBUTE_DIRECTORY
+#define A_ARCHIVE	FILE_ATTRIBUTE_ARCHIVE
+#define A_TEMPORARY	FILE_ATTRIBUTE_TEMPORARY
+#define A_COMPRESSED	FILE_ATTRIBUTE_COMPRESSED
+#define A_OFFLINE	FILE_ATTRIBUTE_OFFLINE
+#define A_DEVICE	FILE_ATTRIBUTE_DEVICE
+#define A_ENCRYPTED	FILE_ATTRIBUTE_ENCRYPTED
+#define A_VIRTUAL	FILE_ATTRIBUTE_VIRTUAL
+#define A_REPARSE	FILE_ATTRIBUTE_REPARSE_POINT
+
+#define IO_REPARSE_TAG_SURROGATE	0x20000000	/* Name surrogate (link) */
+
+#define FILE_CASE_SENSITIVE_CLASS	23	/* FileCaseSensitiveInfo	*/
+#ifndef FILE_CS_FLAG_CASE_SENSITIVE_DIR
+ #define FILE_CS_FLAG_CASE_SENSITIVE_DIR	0x00000001
+#endif
+
+#define VISIT_DIR	1		/* Directory searched		*/
+#define VISIT_GLOB	2		/* Directory expanded by "**"	*/
+
+#define AX_NORMAL	(0x20000000|A_NORMAL)	/* Phony bit	*/
+#define AX_WRITABLE	0x10000000		/* Phony bit	*/
+#define AX_DFL		0x00FFFFFF
+
+
+/* DOS filename constants */
+#define SEP_STR		"\\"
+#define SEP_CHAR	'\\'
+#define WILD_DOS	"*.*"
+#define WILD_WIN32	"*"
+#define WILD_FILE	"?*[!`\x1A"	/* Filename wildcard chars	*/
+#define WILD_DIR	"?*["		/* Dir component wildcard chars	*/
+
+#define BLOCKSIZE	512	/* DOS low-level block size		*/
+
+
+/* Output buffering constants */
+#define OUT_BUFSIZE	(64*1024)	/* Size of each output buffer	*/
+#define OUT_NBUFS	8		/* Output buffers in the ring	*/
+
+
+/* Parallel search constants */
+#define MAX_JOBS	64		/* Maximum search threads	*/
+#define MAX_EXCL	64		/* Maximum '-x' patterns	*/
+#define IGN_SLOTS	1024		/* Ignore file cache hash size	*/
+
+
+/* Sorted output constants */
+#define SORT_MEMCAP	(64*1024*1024)	/* Default sort memory cap	*/
+#define SORT_MINCAP	(256*1024)	/* Minimum per-thread memory cap */
+#define SORT_CHUNK	(64*1024)	/* Sort record arena chunk size	*/
+#define SORT_PATHMAX	(16*1024+1)	/* Maximum sorted pathname size	*/
+#define SORT_FANIN	64		/* Sort runs merged at a time	*/
+#define RADIX_MIN	32		/* Smallest radix sorted bucket	*/
+
+
+/* Histogram constants */
+#define HIST_SIZES	65		/* Size buckets: 0, [2^(k-1),2^k) */
+#define HIST_AGES	10		/* Age buckets (see hist_ages[]) */
+
+
+/* Program exit codes */
+enum ExitCodes
+{
+    RC_OKAY =		0,	/* Successful				*/
+    RC_ERR =		1,	/* An error occurred			*/
+    RC_WRITE =		2,	/* Output write failed (e.g., closed pipe) */
+    RC_USAGE =		255	/* Invalid usage			*/
+};
+
+
+/* Output listing formats */
+enum Formats
+{
+    FMT_TEXT =		0,	/* Plain text, one pathname per line	*/
+    FMT_DIRS =		1,	/* Compact, directory prefixes once	*/
+    FMT_FRONT =		2,	/* Compact, front-coded dir prefixes	*/
+    FMT_BIN =		3,	/* Binary entry records			*/
+    FMT_JSON =		4	/* JSON object per line			*/
+};
+
+
+/* Sorted output keys */
+enum SortKeys
+{
+    SORT_NONE =		0,	/* Print entries as they are found	*/
+    SORT_NAME =		1,	/* Sort by pathname			*/
+    SORT_SIZE =		2,	/* Sort by file size			*/
+    SORT_MTIME =	3,	/* Sort by modification time		*/
+    SORT_DIR =		4	/* Sort each directory by name		*/
+};
+
+
+/* Group-by keys */
+enum GroupKeys
+{
+    GROUP_NONE =	0,	/* No grouping				*/
+    GROUP_EXT =		1,	/* File name extension			*/
+    GROUP_OWNER =	2,	/* Owner account			*/
+    GROUP_DEPTH =	3	/* Subdirectory depth			*/
+};
+
+
+/* Compact listing format
+*
+*	A compact listing ('-F dirs' or '-F front') begins with the line
+*	DIRS_MAGIC.  Each following line is either a directory prefix record or
+*	an entry name.  A prefix record is of the form "|N|suffix", and sets the
+*	current directory prefix to the first N characters of the previous
+*	prefix followed by 'suffix' (N is always 0 for '-F dirs').  An entry
+*	name line stands for the current prefix followed by the name.
+*	Since '|' cannot occur in a Win32 filename, the two kinds of lines
+*	cannot be confused.
+*/
+#define DIRS_MAGIC	"|vfind|dirs|1"	/* Compact listing header line	*/
+#define DIRS_CHAR	'|'		/* Prefix record delimiter	*/
+
+
+/* Binary listing format
+*
+*	A binary listing ('-F bin') begins with the 8 bytes of BIN_MAGIC,
+*	followed by one record per entry.  All numbers are unsigned and are
+*	stored in little-endian byte order.  Each record is laid out as:
+*
+*	    Offset  Size  Field
+*	    ------  ----  -----
+*	     0       4    Record length, not counting this field (22 + P)
+*	     4       8    File size, in bytes
+*	    12       8    Last modification time, in 100 ns ticks since
+*	                  1601-01-01 00:00:00 UTC (a Win32 FILETIME)
+*	    20       4    File attribute bits (Win32 FILE_ATTRIBUTE_XXX)
+*	    24       2    Pathname length (P)
+*	    26       P    Pathname, as printed by a text listing
+*	                  (without a terminating null)
+*
+*	Readers should skip any record bytes beyond those they understand,
+*	so that fields can be added after the pathname.
+*/
+#define BIN_MAGIC	"VFNDBIN2"	/* Binary listing header	*/
+#define BIN_MAGICLEN	8		/* Binary listing header size	*/
+#define BIN_HDRSIZE	22		/* Record fields before path	*/
+
+
+#ifdef _MSC_VER
+ #pragma comment(lib, "advapi32.lib")	/* For '-group owner' */
+#endif
+
+
+/*==============================================================================
+* Debug macros
+*/
+
+#ifndef DEBUG
+ #define DEBUG	0
+#endif
+
+#if DEBUG-0 <= 0
+ #undef  DEBUG
+ #define DEBUG	0
+#endif
+
+#if DEBUG
+ #define DL(e)	(opt_debug ? (void)((e), fflush(stdout)) : (void)0)
+#else
+ #define DL(e)	((void)0)
+#endif
+
+
+/*==============================================================================
+* Private types
+*/
+
+/* search_info -- Win/32 file search control object */
+struct search_info
+{
+    HANDLE		fhandle;	/* File search handle		*/
+    struct _WIN32_FIND_DATAA
+			fdata;		/* Search info			*/
+};
+
+
+/* Opt -- Command-line user options */
+struct Opt
+{
+    const char *	o_date1;	/* Date criteria (1st)		*/
+    const char *	o_date2;	/* Date criteria (2nd)		*/
+    struct _FILETIME	o_date1_v;	/* Date/time stamp criteria	*/
+    struct _FILETIME	o_date2_v;	/* Date/time stamp criteria	*/
+    const char *	o_size1;	/* Size criteria (1st)		*/
+    const char *	o_size2;	/* Size criteria (2nd)		*/
+    uint64_t		o_size1_v;	/* Size criteria		*/
+    uint64_t		o_size2_v;	/* Size criteria		*/
+    const char *	o_type;		/* Type criteria		*/
+    unsigned long	o_typemask;	/* Type attributes bitmask	*/
+    const char *	o_user;		/* User-ID criteria		*/
+    const char *	o_group;	/* Group-ID criteria		*/
+    bool		o_verbose;	/* Print verbose messages	*/
+    bool		o_longlist;	/* Print long listing		*/
+    bool		o_summary;	/* Print summary counts		*/
+    bool		o_all;		/* Search for all entries	*/
+    bool		o_almostall;	/* Search for all but "."	*/
+    bool		o_nosubdirs;	/* Don't search subdirs		*/
+    bool		o_dosnames;	/* Use short MS-DOS names	*/
+    bool		o_nameonly;	/* Names without drive/path	*/
+    bool		o_utczone;	/* Dates/times are UTC TZ	*/
+    const char *	o_fmt;		/* Output format name		*/
+    int			o_format;	/* Output format (FMT_XXX)	*/
+    bool		o_expand;	/* Expand listing files		*/
+    bool		o_nulterm;	/* Null-terminated names	*/
+    int			o_jobs;		/* Search threads		*/
+    bool		o_unordered;	/* Print in any order (with -j)	*/
+    const char *	o_sortkey;	/* Sort key name		*/
+    int			o_sort;		/* Sort key (SORT_XXX)		*/
+    bool		o_sortrev;	/* Sort in descending order	*/
+    uint64_t		o_sortmem;	/* Sort memory cap		*/
+    const char *	o_top;		/* Top entries spec		*/
+    size_t		o_topn;		/* Top entries to print		*/
+    bool		o_du;		/* Print directory usage totals	*/
+    int			o_dudepth;	/* Directory usage depth limit	*/
+    bool		o_hist;		/* Print size and age histograms */
+    uint64_t		o_now;		/* Current time (FILETIME)	*/
+    const char *	o_groupby;	/* Group-by key name		*/
+    int			o_groupkey;	/* Group-by key (GROUP_XXX)	*/
+    bool		o_count;	/* Print only the count totals	*/
+    long		o_estreads;	/* Estimate, reading N dirs	*/
+    long		o_max;		/* Stop after N matches		*/
+    bool		o_quiet;	/* Exit status only		*/
+    const char *	o_excl[MAX_EXCL];	/* Excluded dir patterns */
+    int			o_nexcl;	/* Excluded dir pattern count	*/
+    int			o_maxdepth;	/* Max subdir depth searched, or -1 */
+    int			o_mindepth;	/* Min subdir depth matched	*/
+    bool		o_prunematch;	/* Do not search matching dirs	*/
+    bool		o_ignore;	/* Read ignore files		*/
+    bool		o_follow;	/* Follow directory links	*/
+    bool		o_nolist;	/* Do not print the entries	*/
+};
+
+
+/* Count -- Count totals */
+struct Count
+{
+    uint64_t		c_dir;		/* Directories			*/
+    uint64_t		c_file;		/* Files			*/
+    uint64_t		c_hidden;	/* Hidden entries		*/
+    uint64_t		c_bytes;	/* Bytes			*/
+    uint64_t		c_blocks;	/* Blocks (512 bytes)		*/
+    uint64_t		c_sizes[HIST_SIZES];	/* Entries by size	*/
+    uint64_t		c_sizebytes[HIST_SIZES];	/* Bytes by size */
+    uint64_t		c_ages[HIST_AGES];	/* Entries by age	*/
+    uint64_t		c_agebytes[HIST_AGES];	/* Bytes by age		*/
+};
+
+
+/* OutBuf -- Formatted output buffer */
+struct OutBuf
+{
+    size_t		b_len;		/* Bytes in the buffer		*/
+    char		b_data[OUT_BUFSIZE];	/* Formatted output	*/
+};
+
+
+/* OutRing -- Ring of output buffers drained by a writer thread
+*
+*	The traversal (the only producer) fills the buffer at 'r_head' and
+*	the writer thread (the only consumer) drains the buffer at 'r_tail', so
+*	neither index needs a lock.  The two semaphores count the filled and
+*	the empty buffers, which blocks the writer when there is nothing to
+*	write and blocks the traversal when all of the buffers are full.
+*/
+struct OutRing
+{
+    FILE *		r_out;		/* Output stream		*/
+    HANDLE		r_thread;	/* Writer thread, or null	*/
+    HANDLE		r_filled;	/* Filled buffer count (sem)	*/
+    HANDLE		r_empty;	/* Empty buffer count (sem)	*/
+    unsigned int	r_head;		/* Next buffer to fill		*/
+    unsigned int	r_tail;		/* Next buffer to drain		*/
+    volatile LONG	r_error;	/* Output write failed		*/
+    int			r_errno;	/* Output write error code	*/
+    struct OutBuf *	r_cur;		/* Buffer being filled		*/
+    struct OutBuf	r_buf[OUT_NBUFS];	/* Buffer ring		*/
+};
+
+
+/* SortRec -- Entry record of a sorted listing
+*
+*	The fields preceding 'e_path' (SORT_RECHDR bytes) are written as is to
+*	the sort run files, followed by the 'e_len' characters of the printed
+*	pathname and its terminating null.
+*/
+struct SortRec
+{
+    uint64_t		e_size;		/* File size			*/
+    uint64_t		e_mtime;	/* Modification time (FILETIME)	*/
+    unsigned int	e_attr;		/* File attributes		*/
+    unsigned int	e_prelen;	/* Path prefix length		*/
+    unsigned int	e_len;		/* Pathname length		*/
+    char		e_path[1];	/* Pathname (variable size)	*/
+};
+
+#define SORT_RECHDR	offsetof(struct SortRec, e_path)
+
+
+/* SortChunk -- Arena chunk holding sort records */
+struct SortChunk
+{
+    struct SortChunk *	k_next;		/* Next chunk			*/
+    size_t		k_used;		/* Bytes allocated		*/
+    uint64_t		k_data[SORT_CHUNK/sizeof(uint64_t)];	/* Records */
+};
+
+
+/* Sorter -- Entry records being collected for a sorted listing
+*
+*	Each search thread collects the entries it finds into its own sorter,
+*	until the memory they take would exceed the thread's share of the
+*	'-M' memory cap.  The records are then sorted and written to a sort run
+*	file, and the runs are merged together once the search is complete.
+*/
+struct Sorter
+{
+    struct SortRec **	s_recs;		/* Records			*/
+    size_t		s_nrecs;	/* Records held			*/
+    size_t		s_max;		/* Record pointer array size	*/
+    struct SortChunk *	s_chunks;	/* Record arena			*/
+    uint64_t		s_used;		/* Memory used			*/
+};
+
+
+/* SortRun -- Sorted run of entry records */
+struct SortRun
+{
+    struct SortRun *	u_next;		/* Next run			*/
+    FILE *		u_fp;		/* Run file, or null		*/
+    char		u_name[MAX_PATH+1];	/* Run file name	*/
+    struct SortRec **	u_recs;		/* Records held in memory	*/
+    size_t		u_n;		/* Records left in memory	*/
+    struct SortRec *	u_rec;		/* Current record, or null	*/
+    struct SortRec *	u_buf;		/* Record read buffer		*/
+};
+
+
+/* RunList -- Spilled sort runs */
+struct RunList
+{
+    CRITICAL_SECTION	l_lock;		/* List lock			*/
+    struct SortRun *	l_first;	/* Oldest run			*/
+    struct SortRun *	l_last;		/* Newest run			*/
+    int			l_count;	/* Runs				*/
+};
+
+
+/* TopHeap -- Best entries found for a '-top' listing */
+struct TopHeap
+{
+    struct SortRec **	t_recs;		/* Records (heap, worst first)	*/
+    size_t		t_n;		/* Records held			*/
+    size_t		t_max;		/* Record pointer array size	*/
+};
+
+
+/* Group -- Totals of the entries having one '-group' key */
+struct Group
+{
+    const char *	g_key;		/* Key (null if slot is empty)	*/
+    unsigned int	g_keylen;	/* Key length			*/
+    unsigned int	g_hash;		/* Key hash value		*/
+    uint64_t		g_count;	/* Entries			*/
+    uint64_t		g_bytes;	/* Bytes			*/
+};
+
+
+/* GroupMap -- Hash map of '-group' keys to their totals
+*
+*	The map is an open-addressed hash table, whose size is a power of 2.
+*	The keys are copied into an arena when they are first added, so adding
+*	an entry with an existing key allocates nothing.
+*/
+struct GroupMap
+{
+    struct Group *	m_slots;	/* Hash table			*/
+    size_t		m_size;		/* Hash table size		*/
+    size_t		m_n;		/* Keys				*/
+    struct SortChunk *	m_keys;		/* Key arena			*/
+};
+
+
+/* IgnoreRule -- Rule read from an ignore file ('.gitignore' or '.vfindignore') */
+struct IgnoreRule
+{
+    char *		r_pat;		/* Filename pattern		*/
+    bool		r_neg;		/* Rule re-includes ('!pat')	*/
+    bool		r_dir;		/* Matches only dirs ('pat/')	*/
+    bool		r_path;		/* Matches the relative path	*/
+};
+
+
+/* IgnoreFile -- Ignore rules of one directory
+*
+*	The rules of each directory having ignore files are read once, and are
+*	kept in a hash table (chained) of directory paths for the whole run.
+*/
+struct IgnoreFile
+{
+    struct IgnoreFile *	f_next;		/* Next in the hash chain	*/
+    char *		f_dir;		/* Directory path		*/
+    size_t		f_dirlen;	/* Directory path length	*/
+    unsigned int	f_hash;		/* Directory path hash value	*/
+    struct IgnoreRule *	f_rules;	/* Rules, in file order		*/
+    int			f_n;		/* Rules			*/
+    struct Ignores *	f_stacks;	/* Stacks of these rules	*/
+};
+
+
+/* Ignores -- Ignore rules in effect for a directory
+*
+*	The rules of a directory are stacked on top of those of its parent
+*	directories, so that the rules of deeper ignore files take precedence.
+*	The stacks are kept with the rules of each directory (usually one per
+*	directory), and are shared by the directories below it.
+*/
+struct Ignores
+{
+    const struct IgnoreFile *	i_file;	/* Rules of this directory	*/
+    const struct Ignores *	i_up;	/* Rules of the parent dirs	*/
+    struct Ignores *		i_next;	/* Next stack of the same rules	*/
+};
+
+
+/* IgnoreCache -- Ignore files already read */
+struct IgnoreCache
+{
+    CRITICAL_SECTION	c_lock;		/* Cache lock			*/
+    struct IgnoreFile *	c_slots[IGN_SLOTS];	/* Hash chains		*/
+};
+
+
+/* DirId -- Identity of a directory searched with '-follow' */
+struct DirId
+{
+    DWORD		i_serial;	/* Volume serial number		*/
+    DWORD		i_idhi;		/* File index (high 32 bits)	*/
+    DWORD		i_idlo;		/* File index (low 32 bits)	*/
+    unsigned int	i_hash;		/* Hash value			*/
+    int			i_kind;		/* How it was visited (0 if empty) */
+};
+
+
+/* DirIdSet -- Directories already visited, when following directory links
+*
+*	The set is an open-addressed hash table, whose size is a power of 2,
+*	shared by the parallel search threads.
+*/
+struct DirIdSet
+{
+    CRITICAL_SECTION	s_lock;		/* Set lock			*/
+    struct DirId *	s_slots;	/* Hash table			*/
+    size_t		s_size;		/* Hash table size		*/
+    size_t		s_n;		/* Directories			*/
+};
+
+
+/* Dir -- Directory searched by a parallel search thread
+*
+*	Each directory of a parallel search ('-j') is searched by one of the
+*	search threads, which formats the entries it prints into its own
+*	buffer and saves the output in the directory's 'd_out'.  The
+*	subdirectories found are linked in order from 'd_child', so that the
+*	main thread can print the saved output of the whole tree in the same
+*	(depth-first) order as a single-threaded search.
+*/
+struct Dir
+{
+    char *		d_pat;		/* Search pattern		*/
+    struct Dir *	d_child;	/* First subdirectory		*/
+    struct Dir *	d_last;		/* Last subdirectory		*/
+    struct Dir *	d_next;		/* Next sibling directory	*/
+    struct Dir *	d_qnext;	/* Next directory in work queue	*/
+    char *		d_out;		/* Saved output			*/
+    size_t		d_outlen;	/* Saved output size		*/
+    int			d_depth;	/* Subdirectory depth		*/
+    const struct Ignores *	d_ignore;	/* Ignore rules of parents */
+    char *		d_path;		/* Directory name (with -du)	*/
+    struct Count	d_count;	/* Count totals (with -du)	*/
+    volatile LONG	d_done;		/* Directory has been searched	*/
+};
+
+
+/* Walk -- Parallel search thread state */
+struct Walk
+{
+    struct Dir *	w_dir;		/* Directory being searched	*/
+    uint64_t		w_matches;	/* Matching entries found	*/
+    struct Sorter	w_sort;		/* Sorted output records	*/
+    struct TopHeap	w_top;		/* Top entries			*/
+    struct GroupMap	w_group;	/* Group-by totals		*/
+    struct OutBuf	w_buf;		/* Formatted output		*/
+};
+
+
+/* WorkQueue -- Parallel search work queue
+*
+*	Directories waiting to be searched are kept on a stack, with the
+*	subdirectories of a directory pushed so that the first one is on top,
+*	which makes the search threads proceed in roughly depth-first order.
+*/
+struct WorkQueue
+{
+    CRITICAL_SECTION	q_lock;		/* Queue lock			*/
+    CRITICAL_SECTION	q_outlock;	/* Output ring lock (unordered)	*/
+    struct Dir *	q_top;		/* Directories to search	*/
+    HANDLE		q_avail;	/* Queued directory count (sem)	*/
+    HANDLE		q_progress;	/* Directory searched (event)	*/
+    volatile LONG	q_pending;	/* Directories not yet searched	*/
+    volatile LONG	q_active;	/* Search threads running	*/
+    uint64_t		q_matches;	/* Total matching entries	*/
+    bool		q_flat;		/* Do not search the subdirs	*/
+    struct Count	q_count;	/* Total counts			*/
+};
+
+
+/*==============================================================================
+* Private variables
+*/
+
+static struct Opt	opt;
+static THREAD_LOCAL struct Count	count;
+static struct OutRing	outq;
+static struct WorkQueue	work;
+static struct Sorter	sorter;		/* Main thread sorted output	*/
+static struct RunList	runs;
+static struct TopHeap	top;		/* Main thread top entries	*/
+static struct GroupMap	groups;		/* Main thread group-by totals	*/
+static unsigned char	sort_fold[256];	/* Folded (lowercase) chars	*/
+static uint64_t		est_seed;	/* Estimate random number seed	*/
+static volatile LONG	found;		/* Matches counted for '-max'	*/
+static volatile LONG	stopped;	/* Search stopped early		*/
+static volatile LONG	omitted;	/* Entries left out by an error	*/
+static bool		lookup_name;	/* Look up the filename directly */
+static bool		lookup_dirs;	/* Check each dir for case first */
+static bool		visit_once;	/* Search each directory once	*/
+static THREAD_LOCAL struct Walk *	walk;	/* Search thread, or null */
+static THREAD_LOCAL int	dir_depth;	/* Subdirectory depth searched	*/
+static struct IgnoreCache	ignq;	/* Ignore files read		*/
+static struct DirIdSet	visited;	/* Dirs visited ('-follow', "**") */
+static THREAD_LOCAL const struct Ignores *	ignores;
+					/* Ignore rules being applied	*/
+static THREAD_LOCAL char	last_prefix[16*1024+1] = { DIRS_CHAR, '\0' };
+					/* Last compact listing prefix	*/
+static THREAD_LOCAL char *	json_key;	/* Last JSON path prefix	*/
+static THREAD_LOCAL char *	json_pre;	/* Its JSON string form		*/
+static THREAD_LOCAL size_t	json_prelen;	/* Length of 'json_pre'		*/
+static char		fsinfo_buf[256];
+
+
+/*==============================================================================
+* Public variables
+*/
+
+bool			opt_debug = false;
+
+
+/*==============================================================================
+* Functions
+*/
+
+/*------------------------------------------------------------------------------
+* findfirst32()
+*
+* Returns
+*	True on success, otherwise false.
+*/
+
+static bool findfirst32(const char *pat, unsigned int attr, struct search_info *info)
+{
+    /* Start the file searching */
+    info->fhandle = FindFirstFileA(pat, &info->fdata);
+
+    /* Handle DOS short filenames */
+    if (opt.o_dosnames  and  info->fdata.cAlternateFileName[0] != '\0')
+        memcpy(info->fdata.cFileName,
+            info->fdata.cAlternateFileName,
+            sizeof(info->fdata.cAlternateFileName));
+
+    DL(printf("first: \"%.999s\"\n", info->fdata.cFileName));
+    DL(printf("info->fhandle=%08lX\n", (long)info->fhandle));
+
+    if (info->fhandle == INVALID_HANDLE_VALUE)
+        info->fhandle = NULL;
+    return (info->fhandle != NULL);
+}
+
+
+/*------------------------------------------------------------------------------
+* findnext32()
+*
+* Returns
+*	True on success, otherwise false.
+*/
+
+static bool findnext32(struct search_info *info)
+{
+    bool	found;
+
+    /* Continue the file searching */
+    found = FindNextFile(info->fhandle, &info->fdata);
+
+    if (not found)
+    {
+        /* Close the search handle */
+        FindClose(info->fhandle);
+        info->fhandle = NULL;
+    }
+    else if (opt.o_dosnames  and  info->fdata.cAlternateFileName[0] != '\0')
+    {
+        /* Handle DOS short filenames */
+        memcpy(info->fdata.cFileName,
+            info->fdata.cAlternateFileName,
+            sizeof(info->fdata.cAlternateFileName));
+    }
+
+    DL(printf("next: \"%.999s\"\n", info->fdata.cFileName));
+    return found;
+}
+
+
+/*------------------------------------------------------------------------------
+* findclose32()
+*	Closes an unfinished file search, if any.
+*/
+
+static void findclose32(struct search_info *info)
+{
+    if (info->fhandle != NULL)
+    {
+        FindClose(info->fhandle);
+        info->fhandle = NULL;
+    }
+}
+
+
+/*------------------------------------------------------------------------------
+* compare_filetimes()
+*	Compare two file timestamps.
+*
+* Returns
+*	A signed value which is:
+*	- positive if date 'a' is later than date 'b',
+*	- negative if date 'a' is earlier than date 'b',
+*	- zero if date 'a' is the same as date 'b'.
+*/
+
+static int compare_filetimes(const struct _FILETIME *a, const struct _FILETIME *b)
+{
+    /* Compare the two file timestamps */
+    if (a->dwHighDateTime > b->dwHighDateTime)
+        return +1;
+    if (a->dwHighDateTime < b->dwHighDateTime)
+        return -1;
+    if (a->dwLowDateTime > b->dwLowDateTime)
+        return +1;
+    if (a->dwLowDateTime < b->dwLowDateTime)
+        return -1;
+    return 0;
+}
+
+
+/*------------------------------------------------------------------------------
+* exclude_dir()
+*	Determine if directory name 'name' matches any of the '-x' patterns.
+*
+* Returns
+*	True if the directory is excluded, otherwise false.
+*/
+
+static bool exclude_dir(const char *name)
+{
+    int		i;
+
+    for (i = 0;  i < opt.o_nexcl;  i++)
+    {
+        if (fpattern_matchn(opt.o_excl[i], name))
+            return true;
+    }
+    return false;
+}
+
+
+/*------------------------------------------------------------------------------
+* enter_dir()
+*	Determine if directory entry info 'info' is a subdirectory that should
+*	be searched.  Directory links (junctions and symbolic links) are only
+*	searched if '-follow' is specified.
+*
+* Returns
+*	True if the subdirectory should be searched, otherwise false.
+*/
+
+static bool enter_dir(const struct _WIN32_FIND_DATAA *info)
+{
+    if ((info->dwFileAttributes & A_DIRECTORY) == 0)
+        return false;
+    if ((info->dwFileAttributes & A_REPARSE) != 0
+        and  (info->dwReserved0 & IO_REPARSE_TAG_SURROGATE) != 0
+        and  not opt.o_follow)
+        return false;		/* Junction or symbolic link */
+    if (strcmp(info->cFileName, ".") == 0  or
+        strcmp(info->cFileName, "..") == 0)
+        return false;
+    if (opt.o_nexcl > 0  and  exclude_dir(info->cFileName))
+        return false;
+    return true;
+}
+
+
+/*------------------------------------------------------------------------------
+* visit_find()
+*	Finds the slot for directory identity 'id' of kind 'kind' in set 's',
+*	which is either the slot holding it or the empty slot for adding it.
+*/
+
+static struct DirId * visit_find(struct DirIdSet *s, const struct DirId *id, int kind)
+{
+    size_t		i;
+    struct DirId *	d;
+
+    for (i = id->i_hash & (s->s_size-1);  ;  i = (i+1) & (s->s_size-1))
+    {
+        d = &s->s_slots[i];
+        if (d->i_kind == 0)
+            return d;
+        if (d->i_hash == id->i_hash  and  d->i_kind == kind
+            and  d->i_idlo == id->i_idlo  and  d->i_idhi == id->i_idhi
+            and  d->i_serial == id->i_serial)
+            return d;
+    }
+}
+
+
+/*------------------------------------------------------------------------------
+* visit_dir()
+*	Records directory 'path' as visited, for the purpose 'kind' (VISIT_XXX),
+*	while following directory links ('-follow') or searching a pattern
+*	with several "**" components.  A directory is identified
+*	by its volume serial number and file index, so a directory reached
+*	again through a link (or a link loop) is recognized.
+*
+* Returns
+*	True if the directory has not been visited before (or cannot be
+*	identified), otherwise false.
+*/
+
+static bool visit_dir(const char *path, int kind)
+{
+    HANDLE		fh;
+    BY_HANDLE_FILE_INFORMATION	fi;
+    struct DirId	id;
+    struct DirId *	d;
+    bool		ok;
+
+    /* Identify the directory */
+    fh = CreateFileA(path[0] != '\0' ? path : ".", 0,
+        FILE_SHARE_READ|FILE_SHARE_WRITE|FILE_SHARE_DELETE, NULL,
+        OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, NULL);
+    if (fh == INVALID_HANDLE_VALUE)
+        return true;
+    ok = GetFileInformationByHandle(fh, &fi);
+    CloseHandle(fh);
+    if (not ok)
+        return true;
+
+    id.i_serial = fi.dwVolumeSerialNumber;
+    id.i_idhi = fi.nFileIndexHigh;
+    id.i_idlo = fi.nFileIndexLow;
+    id.i_hash = ((id.i_serial * 16777619u) ^ id.i_idhi) * 16777619u ^ id.i_idlo;
+    id.i_hash = (id.i_hash ^ (id.i_hash >> 15)) * 2246822519u;
+    id.i_kind = kind;
+
+    EnterCriticalSection(&visited.s_lock);
+
+    /* Grow the set when it is 3/4 full */
+    if ((visited.s_n+1)*4 > visited.s_size*3)
+    {
+        struct DirId *	old = visited.s_slots;
+        size_t		oldsize = visited.s_size;
+        size_t		j;
+
+        visited.s_size = (oldsize > 0 ? oldsize*2 : 256);
+        visited.s_slots = (struct DirId *) calloc(visited.s_size, sizeof(struct DirId));
+        if (visited.s_slots == NULL)
+        {
+            fprintf(stderr, "%s: Out of memory\n", prog);
+            exit(RC_ERR);
+        }
+
+        for (j = 0;  j < oldsize;  j++)
+        {
+            if (old[j].i_kind != 0)
+                *visit_find(&visited, &old[j], old[j].i_kind) = old[j];
+        }
+        free(old);
+    }
+
+    d = visit_find(&visited, &id, kind);
+    ok = (d->i_kind == 0);
+    if (ok)
+    {
+        *d = id;
+        visited.s_n++;
+    }
+    else
+    {
+        DL(printf("|visit_dir: [%.999s] <visited>\n", path));
+    }
+
+    LeaveCriticalSection(&visited.s_lock);
+    return ok;
+}
+
+
+/*------------------------------------------------------------------------------
+* case_dir()
+*	Determine if directory 'path' is case-sensitive, which an NTFS
+*	directory can be made (e.g., "fsutil file setCaseSensitiveInfo").
+*
+* Returns
+*	True if the directory is (or may be) case-sensitive, otherwise false.
+*/
+
+static bool case_dir(const char *path)
+{
+    HANDLE		fh;
+    struct
+    {
+        DWORD		Flags;
+    }			csi;
+    bool		cs;
+
+    fh = CreateFileA(path[0] != '\0' ? path : ".", 0,
+        FILE_SHARE_READ|FILE_SHARE_WRITE|FILE_SHARE_DELETE, NULL,
+        OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, NULL);
+    if (fh == INVALID_HANDLE_VALUE)
+        return true;
+
+    /* Windows versions without case-sensitive directories fail this */
+    cs = (GetFileInformationByHandleEx(fh,
+            (FILE_INFO_BY_HANDLE_CLASS) FILE_CASE_SENSITIVE_CLASS,
+            &csi, sizeof(csi))
+        and  (csi.Flags & FILE_CS_FLAG_CASE_SENSITIVE_DIR) != 0);
+    CloseHandle(fh);
+
+    DL(printf("|case_dir: [%.999s] %d\n", path, cs));
+    return cs;
+}
+
+
+/*------------------------------------------------------------------------------
+* include_entry()
+*	Determine if file entry info 'info' matches selection specifications
+*	and should be printed or not.
+*
+* Returns
+*	True if entry info should be printed, otherwise false.
+*/
+
+static bool include_entry(struct _WIN32_FIND_DATAA *info)
+{
+    DWORD	attr;
+
+    attr = info->dwFileAttributes;
+
+    /* Check the first date spec */
+    if (opt.o_date1 != NULL)
+    {
+        struct _FILETIME	ft;
+        struct _SYSTEMTIME	st;
+        int			cmp;
+
+        ft = info->ftLastWriteTime;
+        FileTimeToSystemTime(&ft, &st);
+        if (not opt.o_utczone)
+        {
+            /* Adjust file time to local time */
+            SystemTimeToTzSpecificLocalTime(NULL, &st, &st);
+            SystemTimeToFileTime(&st, &ft);
+        }
+        DL(printf("|file: %04d-%02d-%02d %02d:%02d:%02d =%08X:%08X\n",
+            st.wYear, st.wMonth, st.wDay,
+            st.wHour, st.wMinute, st.wSecond,
+            ft.dwHighDateTime, ft.dwLowDateTime));
+
+        /* Compare the file time */
+        cmp = compare_filetimes(&ft, &opt.o_date1_v);
+        switch (opt.o_date1[0])
+        {
+        case '+':
+            if (cmp < 0)
+                goto exclude;
+            break;
+
+        case '-':
+            if (cmp > 0)
+                goto exclude;
+            break;
+
+        case '!':
+            if (cmp == 0)
+                goto exclude;
+            break;
+
+        case '=':
+        default:
+            if (cmp != 0)
+                goto exclude;
+            break;
+        }
+    }
+
+    /* Check the second date spec */
+    if (opt.o_date2 != NULL)
+    {
+        struct _FILETIME	ft;
+        struct _SYSTEMTIME	st;
+        int			cmp;
+
+        ft = info->ftLastWriteTime;
+        FileTimeToSystemTime(&ft, &st);
+        if (not opt.o_utczone)
+        {
+            /* Adjust file time to local time */
+            SystemTimeToTzSpecificLocalTime(NULL, &st, &st);
+            SystemTimeToFileTime(&st, &ft);
+        }
+        DL(printf("|file: %04d-%02d-%02d %02d:%02d:%02d =%08X:%08X\n",
+            st.wYear, st.wMonth, st.wDay,
+            st.wHour, st.wMinute, st.wSecond,
+            ft.dwHighDateTime, ft.dwLowDateTime));
+
+        /* Compare the file time */
+        cmp = compare_filetimes(&ft, &opt.o_date2_v);
+        switch (opt.o_date2[0])
+        {
+        case '+':
+            if (cmp < 0)
+                goto exclude;
+            break;
+
+        case '-':
+            if (cmp > 0)
+                goto exclude;
+            break;
+
+        case '!':
+            if (cmp == 0)
+                goto exclude;
+            break;
+
+        case '=':
+        default:
+            if (cmp != 0)
+                goto exclude;
+            break;
+        }
+    }
+
+    /* Check the first size spec */
+    if (opt.o_size1 != NULL)
+    {
+        uint64_t	sz;
+
+        /* Get the file size */
+        sz = ((uint64_t)info->nFileSizeHigh << 32) + info->nFileSizeLow;
+
+        /* Check the file size criterion */
+        switch (opt.o_size1[0])
+        {
+        case '+':
+            if (sz < opt.o_size1_v)
+                goto exclude;
+            break;
+
+        case '-':
+            if (sz > opt.o_size1_v)
+                goto exclude;
+            break;
+
+        case '!':
+            if (sz == opt.o_size1_v)
+                goto exclude;
+            break;
+
+        case '=':
+        default:
+            if (sz != opt.o_size1_v)
+                goto exclude;
+        }
+    }
+
+    /* Check the second size spec */
+    if (opt.o_size2 != NULL)
+    {
+        uint64_t	sz;
+
+        /* Get the file size */
+        sz = ((uint64_t)info->nFileSizeHigh << 32) + info->nFileSizeLow;
+
+        /* Check the file size criterion */
+        switch (opt.o_size2[0])
+        {
+        case '+':
+            if (sz < opt.o_size2_v)
+                goto exclude;
+            break;
+
+        case '-':
+            if (sz > opt.o_size2_v)
+                goto exclude;
+            break;
+
+        case '!':
+            if (sz == opt.o_size2_v)
+                goto exclude;
+            break;
+
+        case '=':
+        default:
+            if (sz != opt.o_size2_v)
+                goto exclude;
+        }
+    }
+
+    /* Check the entry type attributes */
+    if (opt.o_type != NULL)
+    {
+   	bool	incl = false;
+        bool	excl = false;
+
+        /* Adjust the entry attribute bits */
+        if ((attr & A_NORMAL) != 0)
+            attr |= AX_NORMAL;
+        else if ((attr & (A_DIRECTORY|A_VOLUME|A_DEVICE)) == 0)
+            attr |= AX_NORMAL;
+
+        if ((attr & A_READONLY) == 0)
+            attr |= AX_WRITABLE;
+
+        /* Check the entry attributes */
+        if ((attr & opt.o_typemask) != 0)
+            incl = true;
+
+#ifdef not_yet_supported
+        if ((~attr & ~opt.o_typemask2 ???) != 0)
+            excl = true;
+#endif
+
+        if (opt.o_type[0] != '!'  and  (not incl  or  excl))
+            goto exclude;
+        else if (opt.o_type[0] == '!'  and  (incl  and  not excl))
+            goto exclude;
+    }
+
+    /* Check the excluded directories */
+    if (opt.o_nexcl > 0  and  (info->dwFileAttributes & A_DIRECTORY) != 0
+        and  exclude_dir(info->cFileName))
+        goto exclude;
+
+    /* Check the entry name visibility */
+    if (opt.o_all)
+    {
+        /* Include all entries */
+    }
+    else if ((info->dwFileAttributes & (A_SYSTEM|A_HIDDEN)) != 0)
+    {
+        /* Hidden filename */
+        if (not opt.o_almostall  and
+                (strcmp(info->cFileName, ".") == 0  or
+                strcmp(info->cFileName, "..") == 0))
+            goto exclude;
+    }
+    else if (not opt.o_almostall)
+    {
+        /* Check for a dotted name */
+        if (strcmp(info->cFileName, ".")  == 0  or
+            strcmp(info->cFileName, "..") == 0)
+            goto exclude;
+    }
+
+#ifdef is_unsupported
+|   /* Check the owner user name */
+|   if (opt.o_user != NULL)
+|   {
+|       ...
+|   }
+#endif
+
+#ifdef is_unsupported
+|   /* Check the owner group name */
+|   if (opt.o_group != NULL)
+|   {
+|       ...
+|   }
+#endif
+
+include:
+    /* Include the entry */
+    DL(printf("|incl %08lX '%.999s'\n", (unsigned long)attr, info->cFileName));
+    return true;
+
+exclude:
+    /* Exclude the entry */
+    DL(printf("|excl %08lX '%.999s'\n", (unsigned long)attr, info->cFileName));
+    return false;
+}
+
+
+/*------------------------------------------------------------------------------
+* ign_pattern()
+*	Translates ignore file pattern 'p' into the equivalent filename pattern
+*	'd', which must be able to hold at least twice as many chars as 'p'.
+*	The '\' escapes become '`' quotes, and the chars that are special only
+*	to filename patterns ('!', '{', '}', ',', and '`') are quoted.  A "**"
+*	between two '/' matches zero or more directories, and elsewhere it is
+*	the same as '*' (which can match across directories).
+*/
+
+static void ign_pattern(char *d, const char *p)
+{
+    const char *	start = d;
+    bool		inset = false;
+
+    for ( ;  *p != '\0';  p++)
+    {
+        if (inset)
+        {
+            /* Within a '[...]' set */
+            if (*p == ']')
+                inset = false;
+            else if (*p == '\\'  and  p[1] != '\0')
+            {
+                *d++ = '`';
+                p++;
+            }
+            else if (*p == '`')
+                *d++ = '`';
+            *d++ = *p;
+            continue;
+        }
+
+        switch (*p)
+        {
+        case '\\':
+            /* Escaped char */
+            if (p[1] != '\0')
+            {
+                *d++ = '`';
+                *d++ = *++p;
+            }
+            break;
+
+        case '[':
+            /* Set, which may be negated with '!' or '^' */
+            inset = true;
+            *d++ = *p;
+            if (p[1] == '!'  or  p[1] == '^')
+            {
+                *d++ = '!';
+                p++;
+            }
+            if (p[1] == ']')
+            {
+                *d++ = '`';
+                *d++ = *++p;
+            }
+            break;
+
+        case '*':
+            if (p[1] == '*'  and  p[2] == '/'  and  (d == start  or  d[-1] == '/'))
+            {
+                /* Zero or more directories */
+                strcpy(d, "{,*/}");
+                d += 5;
+                p += 2;
+            }
+            else
+            {
+                *d++ = '*';
+                while (p[1] == '*')
+                    p++;
+            }
+            break;
+
+        case '!':
+        case '{':
+        case '}':
+        case ',':
+        case '`':
+        case '\x1A':
+            /* Regular char */
+            *d++ = '`';
+            *d++ = *p;
+            break;
+
+        default:
+            *d++ = *p;
+            break;
+        }
+    }
+    *d = '\0';
+}
+
+
+/*------------------------------------------------------------------------------
+* ign_parse()
+*	Parses line 'line' of an ignore file into rule 'r'.
+*	The rules are a subset of those of '.gitignore' files: blank lines and
+*	'#' comments are skipped, a leading '!' re-includes the entries that
+*	match, a trailing '/' matches only directories, and a pattern that
+*	contains a '/' is matched against the pathname relative to the
+*	directory of the ignore file instead of against the name alone.
+*	The pattern is translated into a filename pattern by ign_pattern().
+*
+* Returns
+*	True if the line is a rule, otherwise false.
+*/
+
+static bool ign_parse(char *line, struct IgnoreRule *r)
+{
+    char *	p = line;
+    size_t	n;
+    bool	lead;
+    char	pat[2*1024+1];
+
+    /* Skip blank and comment lines */
+    n = strlen(p);
+    while (n > 0  and  strchr("\r\n\t ", p[n-1]) != NULL)
+        p[--n] = '\0';
+    if (n == 0  or  p[0] == '#')
+        return false;
+
+    memset(r, 0, sizeof(*r));
+    if (p[0] == '!')
+    {
+        r->r_neg = true;
+        p++;
+    }
+    else if (p[0] == '\\'  and  (p[1] == '#'  or  p[1] == '!'))
+        p++;
+
+    /* Check for a directory-only rule */
+    n = strlen(p);
+    if (n > 0  and  p[n-1] == '/')
+    {
+        r->r_dir = true;
+        p[--n] = '\0';
+    }
+
+    /* Check for a rule anchored to the directory of the ignore file */
+    lead = (p[0] == '/');
+    if (lead)
+        p++;
+    if (strncmp(p, "**/", 3) == 0)
+    {
+        while (strncmp(p, "**/", 3) == 0)
+            p += 3;
+        lead = false;
+    }
+    r->r_path = (lead  or  strchr(p, '/') != NULL);
+
+    ign_pattern(pat, p);
+    if (pat[0] == '\0'  or  not fpattern_isvalid(pat))
+        return false;
+
+    r->r_pat = strdup(pat);
+    if (r->r_pat == NULL)
+    {
+        fprintf(stderr, "%s: Out of memory\n", prog);
+        exit(RC_ERR);
+    }
+    return true;
+}
+
+
+/*------------------------------------------------------------------------------
+* ign_read()
+*	Reads the ignore files ('.gitignore' and then '.vfindignore') of
+*	directory 'dir'.
+*
+* Returns
+*	The rules read, or null if the directory has no ignore files.
+*/
+
+static struct IgnoreFile * ign_read(const char *dir)
+{
+    static const char *	names[2] = { ".gitignore", ".vfindignore" };
+    struct IgnoreFile *	f = NULL;
+    int			max = 0;
+    int			i;
+    size_t		len;
+    char		path[16*1024+1];
+    char		line[1024+1];
+
+    len = strlen(dir);
+    if (len + 1 + strlen(names[1]) >= sizeof(path))
+        return NULL;
+
+    for (i = 0;  i < 2;  i++)
+    {
+        FILE *		fp;
+
+        strcpy(path, dir);
+        if (len > 0  and  path[len-1] != SEP_CHAR  and  path[len-1] != ':')
+            strcat(path, SEP_STR);
+        strcat(path, names[i]);
+
+        fp = fopen(path, "r");
+        if (fp == NULL)
+            continue;
+        DL(printf("|ign_read: [%.999s]\n", path));
+
+        if (f == NULL)
+        {
+            f = (struct IgnoreFile *) calloc(1, sizeof(struct IgnoreFile));
+            if (f == NULL  or  (f->f_dir = strdup(dir)) == NULL)
+            {
+                fprintf(stderr, "%s: Out of memory\n", prog);
+                exit(RC_ERR);
+            }
+            f->f_dirlen = len;
+        }
+
+        while (fgets(line, sizeof(line), fp) != NULL)
+        {
+            struct IgnoreRule	r;
+
+            if (not ign_parse(line, &r))
+                continue;
+
+            if (f->f_n == max)
+            {
+                max = (max > 0 ? max*2 : 16);
+                f->f_rules = (struct IgnoreRule *)
+                    realloc(f->f_rules, max * sizeof(struct IgnoreRule));
+                if (f->f_rules == NULL)
+                {
+                    fprintf(stderr, "%s: Out of memory\n", prog);
+                    exit(RC_ERR);
+                }
+            }
+            f->f_rules[f->f_n++] = r;
+        }
+        fclose(fp);
+    }
+
+    return f;
+}
+
+
+/*------------------------------------------------------------------------------
+* ign_enter()
+*	Finds the ignore rules of the directory 'drive' and 'pre' being
+*	searched, reading its ignore files if they have not already been read.
+*
+* Returns
+*	The ignore rules in effect for the directory, which are its own rules
+*	stacked on the rules in effect for its parent directory, 'ignores'.
+*/
+
+static const struct Ignores * ign_enter(const char *drive, const char *pre)
+{
+    struct IgnoreFile *	f;
+    struct IgnoreFile *	nf = NULL;
+    struct Ignores *	ig;
+    unsigned int	h;
+    size_t		len;
+    size_t		i;
+    char		dir[16*1024+1];
+
+    if (strlen(drive) + strlen(pre) >= sizeof(dir))
+        return ignores;
+    strcpy(dir, drive);
+    strcat(dir, pre);
+    len = strlen(dir);
+
+    /* Hash the directory path (FNV-1a) */
+    h = 2166136261u;
+    for (i = 0;  i < len;  i++)
+        h = (h ^ (unsigned char) dir[i]) * 16777619u;
+
+    /* Look for the rules already read, reading them if necessary */
+    for (;;)
+    {
+        EnterCriticalSection(&ignq.c_lock);
+        for (f = ignq.c_slots[h % IGN_SLOTS];  f != NULL;  f = f->f_next)
+        {
+            if (f->f_hash == h  and  f->f_dirlen == len
+                and  memcmp(f->f_dir, dir, len) == 0)
+                break;
+        }
+        if (f == NULL  and  nf != NULL)
+        {
+            /* Add the rules just read to the cache */
+            nf->f_hash = h;
+            nf->f_next = ignq.c_slots[h % IGN_SLOTS];
+            ignq.c_slots[h % IGN_SLOTS] = nf;
+            f = nf;
+            nf = NULL;
+        }
+        LeaveCriticalSection(&ignq.c_lock);
+
+        if (f != NULL  or  nf != NULL)
+            break;
+
+        /* Read the ignore files (without holding the lock) */
+        nf = ign_read(dir);
+        if (nf == NULL)
+            return ignores;
+    }
+
+    if (nf != NULL)
+    {
+        /* Another search thread read the same rules */
+        for (i = 0;  i < (size_t) nf->f_n;  i++)
+            free(nf->f_rules[i].r_pat);
+        free(nf->f_rules);
+        free(nf->f_dir);
+        free(nf);
+    }
+
+    if (f->f_n == 0)
+        return ignores;
+
+    /* Stack the rules on top of those of the parent directories, reusing
+    the stack made when the directory was last searched */
+    EnterCriticalSection(&ignq.c_lock);
+    for (ig = f->f_stacks;  ig != NULL;  ig = ig->i_next)
+    {
+        if (ig->i_up == ignores)
+            break;
+    }
+    if (ig == NULL)
+    {
+        ig = (struct Ignores *) malloc(sizeof(struct Ignores));
+        if (ig == NULL)
+        {
+            fprintf(stderr, "%s: Out of memory\n", prog);
+            exit(RC_ERR);
+        }
+        ig->i_file = f;
+        ig->i_up = ignores;
+        ig->i_next = f->f_stacks;
+        f->f_stacks = ig;
+    }
+    LeaveCriticalSection(&ignq.c_lock);
+    return ig;
+}
+
+
+/*------------------------------------------------------------------------------
+* ign_match()
+*	Determine if directory entry info 'info', within the directory 'drive'
+*	and 'pre' being searched, is ignored by the ignore rules in effect.
+*	The last rule that matches the entry decides, and the rules of deeper
+*	directories come after those of their parents.
+*
+* Returns
+*	True if the entry is ignored, otherwise false.
+*/
+
+static bool ign_match(const char *drive, const char *pre,
+    const struct _WIN32_FIND_DATAA *info)
+{
+    const struct Ignores *	ig;
+    const char *	name = info->cFileName;
+    bool		isdir;
+    size_t		drivelen;
+    char		rel[16*1024+1];
+
+    isdir = ((info->dwFileAttributes & A_DIRECTORY) != 0);
+    drivelen = strlen(drive);
+
+    for (ig = ignores;  ig != NULL;  ig = ig->i_up)
+    {
+        const struct IgnoreFile *	f = ig->i_file;
+        bool		haverel = false;
+        int		i;
+
+        for (i = f->f_n-1;  i >= 0;  i--)
+        {
+            const struct IgnoreRule *	r = &f->f_rules[i];
+
+            if (r->r_dir  and  not isdir)
+                continue;
+
+            if (r->r_path)
+            {
+                /* Match the pathname relative to the ignore file */
+                if (not haverel)
+                {
+                    const char *	sub;
+                    char *		p;
+
+                    sub = pre + (f->f_dirlen - drivelen);
+                    while (*sub == SEP_CHAR)
+                        sub++;
+                    if (strlen(sub) + 1 + strlen(name) >= sizeof(rel))
+                        continue;
+                    strcpy(rel, sub);
+                    if (rel[0] != '\0')
+                        strcat(rel, "/");
+                    strcat(rel, name);
+                    for (p = rel;  *p != '\0';  p++)
+                        if (*p == SEP_CHAR)
+                            *p = '/';
+                    haverel = true;
+                }
+                if (not fpattern_matchn(r->r_pat, rel))
+                    continue;
+            }
+            else if (not fpattern_matchn(r->r_pat, name))
+                continue;
+
+            DL(printf("|ign_match: '%.999s' %s\n", name, r->r_neg ? "incl" : "excl"));
+            return (not r->r_neg);
+        }
+    }
+
+    return false;
+}
+
+
+/*------------------------------------------------------------------------------
+* s_attrib()
+*	Convert file attribute 'attr' into a human-readable string form.
+*
+* Returns
+*	Buffer 'buf'.
+*/
+
+static const char * s_attrib(unsigned int attr, char *buf)
+{
+    int		i;
+
+    /* Assemble individual bits of the attribute */
+    i = 0;
+    if (attr & A_DIRECTORY)
+        buf[i++] = 'd';
+    else if (attr & A_VOLUME)
+        buf[i++] = 'l';
+    else if (attr & A_DEVICE)
+        buf[i++] = 'b';
+    else
+        buf[i++] = '-';
+
+    buf[i++] = (attr & 0xFFFF0000 ?   '#' : '-');
+/*
+    if (attr & 0x00080000)
+        buf[i++] = '8';
+    if (attr & 0x00040000)
+        buf[i++] = '4';
+    if (attr & 0x00020000)
+        buf[i++] = '2';
+    if (attr & 0x00010000)
+        buf[i++] = '1';
+    if (attr & 0x00000040)
+        buf[i++] = '6';
+*/
+
+    buf[i++] = (attr & A_VIRTUAL ?    'v' : '-');
+    buf[i++] = (attr & A_ENCRYPTED ?  'e' : '-');
+    buf[i++] = (attr & A_COMPRESSED ? 'c' : '-');
+    buf[i++] = (attr & A_OFFLINE ?    'o' : '-');
+    buf[i++] = (attr & A_TEMPORARY ?  't' : '-');
+    buf[i++] = (attr & A_SYSTEM ?     's' : '-');
+    buf[i++] = (attr & A_HIDDEN ?     'h' : '-');
+    buf[i++] = (attr & A_ARCHIVE   ?  'a' : '-');
+    buf[i++] = (attr & A_READONLY ?   'r' : 'w');
+    buf[i++] = '\0';
+
+    return buf;
+}
+
+
+/*------------------------------------------------------------------------------
+* s_datetime()
+*	Convert filestamp 'ft' into a human-readable string form containing the
+*	date and time.
+*
+* Returns
+*	Pointer to string area 'buf', containing the date and time in the format
+*	"YYYY-MM-DD HH:MM:SS".
+*/
+
+static const char * s_datetime(const struct _FILETIME *ft, char *buf)
+{
+    struct _SYSTEMTIME	st;
+
+    /* Convert filestamp date to broken-down "system" time */
+    FileTimeToSystemTime(ft, &st);
+    if (not opt.o_utczone)
+        SystemTimeToTzSpecificLocalTime(NULL, &st, &st);
+
+    /* Extract and format the filestamp date and time values */
+    sprintf(buf, "%04u-%02u-%02u %02u:%02u:%02u",
+        st.wYear, st.wMonth, st.wDay,
+        st.wHour, st.wMinute, st.wSecond);
+
+    return buf;
+}
+
+
+/*------------------------------------------------------------------------------
+* s_size()
+*	Convert file size 's' into a human-readable string form.
+*
+* Returns
+*	Pointer 'buf'.
+*/
+
+static const char * s_size(uint64_t s, char *buf)
+{
+    char		abuf[40+2];
+    int			i, j;
+    uint64_t		s2;
+
+    /* Extract digits from the number */
+    abuf[40+1] = '\0';
+    for (i = 40*3/4, j = 40;  i >= 0;  i--)
+    {
+        int	d;
+
+        d = s % 10;
+        s2 = s / 10;
+
+        abuf[j--] = (s != 0  or  j == 40 ? d + '0' : ' ');
+
+        s = s2;
+        if (s == 0)
+            break;
+
+        if (i % 3 == 1)
+            abuf[j--] = (s2 != 0 ? ',' : ' ');
+    }
+
+    strcpy(buf, abuf+j+1);
+    return buf;
+}
+
+
+/*------------------------------------------------------------------------------
+* stop_search()
+*	Stops the search, and wakes up any idle search threads to quit.
+*/
+
+static void stop_search(void)
+{
+    if (InterlockedExchange(&stopped, 1) == 0  and  work.q_avail != NULL)
+        ReleaseSemaphore(work.q_avail, MAX_JOBS, NULL);
+}
+
+
+/*------------------------------------------------------------------------------
+* out_failed()
+*	Records a failed write to the output stream, and stops the search,
+*	since nothing else that it finds can be printed.
+*/
+
+static void out_failed(void)
+{
+    if (InterlockedExchange(&outq.r_error, 1) == 0)
+        outq.r_errno = errno;
+    stop_search();
+}
+
+
+/*------------------------------------------------------------------------------
+* out_writer()
+*	Output writer thread.
+*	Writes each filled buffer in the output ring to the output stream, in
+*	order, until a zero-length buffer is found.
+*/
+
+static DWORD WINAPI out_writer(LPVOID arg)
+{
+    struct OutBuf *	b;
+
+    (void) arg;
+
+    for (;;)
+    {
+        /* Wait for the next filled buffer */
+        WaitForSingleObject(outq.r_filled, INFINITE);
+        b = &outq.r_buf[outq.r_tail];
+        outq.r_tail = (outq.r_tail + 1) % OUT_NBUFS;
+
+        if (b->b_len == 0)
+            break;
+
+        /* Write the buffer, discarding it after a write failure */
+        if (outq.r_error == 0)
+        {
+            if (fwrite(b->b_data, 1, b->b_len, outq.r_out) != b->b_len  or
+                    fflush(outq.r_out) != 0)
+                out_failed();
+        }
+
+        /* Return the buffer to the ring */
+        b->b_len = 0;
+        ReleaseSemaphore(outq.r_empty, 1, NULL);
+    }
+
+    return 0;
+}
+
+
+/*------------------------------------------------------------------------------
+* out_init()
+*	Initialize the output buffer ring, writing to stream 'out'.
+*	If 'async' is true, a writer thread is started to drain the buffers,
+*	otherwise full buffers are written directly to 'out'.
+*/
+
+static void out_init(FILE *out, bool async)
+{
+    outq.r_out = out;
+    outq.r_head = 0;
+    outq.r_tail = 0;
+    outq.r_cur = &outq.r_buf[0];
+    outq.r_thread = NULL;
+
+    if (not async)
+        return;
+
+    /* Start the writer thread */
+    outq.r_filled = CreateSemaphore(NULL, 0, OUT_NBUFS, NULL);
+    outq.r_empty =  CreateSemaphore(NULL, OUT_NBUFS-1, OUT_NBUFS, NULL);
+    if (outq.r_filled != NULL  and  outq.r_empty != NULL)
+        outq.r_thread = CreateThread(NULL, 0, out_writer, NULL, 0, NULL);
+
+    DL(printf("|out_init: writer=%08lX\n", (long)outq.r_thread));
+}
+
+
+/*------------------------------------------------------------------------------
+* ring_publish()
+*	Hand the current output ring buffer over to the writer thread, then wait
+*	for an empty buffer to continue filling.
+*/
+
+static void ring_publish(void)
+{
+    if (outq.r_cur->b_len == 0)
+        return;
+
+    if (outq.r_thread == NULL)
+    {
+        /* No writer thread, write the buffer directly */
+        if (outq.r_error == 0  and
+                fwrite(outq.r_cur->b_data, 1, outq.r_cur->b_len, outq.r_out)
+                != outq.r_cur->b_len)
+            out_failed();
+        outq.r_cur->b_len = 0;
+        return;
+    }
+
+    /* Pass the filled buffer to the writer thread */
+    outq.r_head = (outq.r_head + 1) % OUT_NBUFS;
+    ReleaseSemaphore(outq.r_filled, 1, NULL);
+
+    /* Wait for the next empty buffer (blocks while the ring is full) */
+    WaitForSingleObject(outq.r_empty, INFINITE);
+    outq.r_cur = &outq.r_buf[outq.r_head];
+}
+
+
+/*------------------------------------------------------------------------------
+* out_flush()
+*	Write all pending output, waiting until the writer thread is idle.
+*/
+
+static void out_flush(void)
+{
+    int		i;
+
+    ring_publish();
+
+    if (outq.r_thread == NULL)
+    {
+        if (outq.r_out != NULL  and  fflush(outq.r_out) != 0)
+            out_failed();
+        return;
+    }
+
+    /* Wait until every buffer in the ring has been emptied */
+    for (i = 0;  i < OUT_NBUFS-1;  i++)
+        WaitForSingleObject(outq.r_empty, INFINITE);
+    ReleaseSemaphore(outq.r_empty, OUT_NBUFS-1, NULL);
+}
+
+
+/*------------------------------------------------------------------------------
+* out_term()
+*	Write all pending output and stop the writer thread.
+*/
+
+static void out_term(void)
+{
+    out_flush();
+
+    if (outq.r_thread != NULL)
+    {
+        /* Pass a zero-length buffer to stop the writer thread */
+        outq.r_cur->b_len = 0;
+        ReleaseSemaphore(outq.r_filled, 1, NULL);
+        WaitForSingleObject(outq.r_thread, INFINITE);
+
+        CloseHandle(outq.r_thread);
+        CloseHandle(outq.r_filled);
+        CloseHandle(outq.r_empty);
+        outq.r_thread = NULL;
+    }
+}
+
+
+/*------------------------------------------------------------------------------
+* out_status()
+*	Checks for a failed write to the output stream, reporting the error
+*	unless it was caused by a closed pipe (e.g., "vfind ... | head").
+*
+* Returns
+*	RC_WRITE if the output failed, otherwise 'rc'.
+*/
+
+static int out_status(int rc)
+{
+    if (outq.r_error == 0)
+        return rc;
+
+    if (outq.r_errno != EPIPE)
+        fprintf(stderr, "%s: Cannot write the output: %s\n",
+            prog, strerror(outq.r_errno));
+    return RC_WRITE;
+}
+
+
+/*------------------------------------------------------------------------------
+* ring_put()
+*	Append 'len' bytes of 's' to the output ring.
+*/
+
+static void ring_put(const char *s, size_t len)
+{
+    while (len > 0)
+    {
+        struct OutBuf *	b;
+        size_t		n;
+
+        /* Copy as much as fits into the current buffer */
+        b = outq.r_cur;
+        n = OUT_BUFSIZE - b->b_len;
+        if (n > len)
+            n = len;
+        memcpy(b->b_data + b->b_len, s, n);
+        b->b_len += n;
+        s += n;
+        len -= n;
+
+        if (b->b_len == OUT_BUFSIZE)
+            ring_publish();
+    }
+}
+
+
+/*------------------------------------------------------------------------------
+* walk_save()
+*	Empty the output buffer of parallel search thread 'w', saving the
+*	output with the directory being searched.
+*/
+
+static void walk_save(struct Walk *w)
+{
+    struct OutBuf *	b = &w->w_buf;
+    struct Dir *	d = w->w_dir;
+    char *		p;
+
+    if (b->b_len == 0)
+        return;
+
+    /* Save the output with the directory */
+    p = (char *) realloc(d->d_out, d->d_outlen + b->b_len);
+    if (p == NULL)
+    {
+        fprintf(stderr, "%s: Out of memory\n", prog);
+        exit(RC_ERR);
+    }
+    memcpy(p + d->d_outlen, b->b_data, b->b_len);
+    d->d_out = p;
+    d->d_outlen += b->b_len;
+
+    b->b_len = 0;
+}
+
+
+/*------------------------------------------------------------------------------
+* walk_publish()
+*	Empty the output buffer of parallel search thread 'w'.
+*	The output is saved with the directory being searched, or, for an
+*	unordered search ('-U'), is passed directly to the output ring,
+*	together with any output saved when the buffer filled.
+*	This must be called only between output records, since the output
+*	of the other threads may follow it.
+*/
+
+static void walk_publish(struct Walk *w)
+{
+    struct OutBuf *	b = &w->w_buf;
+    struct Dir *	d = w->w_dir;
+
+    if (not opt.o_unordered)
+    {
+        walk_save(w);
+        return;
+    }
+
+    if (b->b_len == 0  and  d->d_outlen == 0)
+        return;
+
+    /* Pass the output to the ring (shared with other threads) */
+    EnterCriticalSection(&work.q_outlock);
+    ring_put(d->d_out, d->d_outlen);
+    ring_put(b->b_data, b->b_len);
+    LeaveCriticalSection(&work.q_outlock);
+
+    free(d->d_out);
+    d->d_out = NULL;
+    d->d_outlen = 0;
+    b->b_len = 0;
+
+    /* The next entry needs a full prefix record of its own ('-F dirs') */
+    last_prefix[0] = DIRS_CHAR;
+    last_prefix[1] = '\0';
+}
+
+
+/*------------------------------------------------------------------------------
+* out_record()
+*	Marks the start of an output record.  The output of an unordered
+*	parallel search ('-U') that filled its buffer is written here, so that
+*	the records of the threads are not mixed together.
+*/
+
+static void out_record(void)
+{
+    if (walk != NULL  and  opt.o_unordered  and  walk->w_dir->d_outlen > 0)
+        walk_publish(walk);
+}
+
+
+/*------------------------------------------------------------------------------
+* out_put()
+*	Append 'len' bytes of 's' to the output.
+*/
+
+static void out_put(const char *s, size_t len)
+{
+    if (walk == NULL)
+    {
+        ring_put(s, len);
+        return;
+    }
+
+    while (len > 0)
+    {
+        struct OutBuf *	b;
+        size_t		n;
+
+        /* Copy as much as fits into this thread's buffer */
+        b = &walk->w_buf;
+        n = OUT_BUFSIZE - b->b_len;
+        if (n > len)
+            n = len;
+        memcpy(b->b_data + b->b_len, s, n);
+        b->b_len += n;
+        s += n;
+        len -= n;
+
+        if (b->b_len == OUT_BUFSIZE)
+            walk_save(walk);
+    }
+}
+
+
+/*------------------------------------------------------------------------------
+* out_putc()
+*	Append character 'ch' to the output.
+*/
+
+static void out_putc(int ch)
+{
+    struct OutBuf *	b;
+
+    b = (walk != NULL ? &walk->w_buf : outq.r_cur);
+    b->b_data[b->b_len++] = (char) ch;
+    if (b->b_len == OUT_BUFSIZE)
+    {
+        if (walk != NULL)
+            walk_save(walk);
+        else
+            ring_publish();
+    }
+}
+
+
+/*------------------------------------------------------------------------------
+* out_puts()
+*	Append string 's' to the output.
+*/
+
+static void out_puts(const char *s)
+{
+    out_put(s, strlen(s));
+}
+
+
+/*------------------------------------------------------------------------------
+* out_putu()
+*	Append unsigned number 'v' in decimal to the output.
+*/
+
+static void out_putu(uint64_t v)
+{
+    int		i;
+    char	buf[20+1];
+
+    i = sizeof(buf);
+    do
+    {
+        buf[--i] = (char) ('0' + v % 10);
+        v /= 10;
+    } while (v != 0);
+
+    out_put(buf+i, sizeof(buf)-i);
+}
+
+
+/*------------------------------------------------------------------------------
+* out_putle()
+*	Append the low-order 'n' bytes of number 'v' to the output, in
+*	little-endian byte order.
+*/
+
+static void out_putle(uint64_t v, int n)
+{
+    int		i;
+    char	buf[8];
+
+    for (i = 0;  i < n;  i++)
+    {
+        buf[i] = (char) (v & 0xFF);
+        v >>= 8;
+    }
+
+    out_put(buf, n);
+}
+
+
+/*------------------------------------------------------------------------------
+* out_printf()
+*	Append formatted text to the output.
+*/
+
+static void out_printf(const char *fmt, ...)
+{
+    va_list	ap;
+    int		len;
+    char	buf[4*1024+1];
+
+    va_start(ap, fmt);
+    len = _vsnprintf(buf, sizeof(buf)-1, fmt, ap);
+    va_end(ap);
+
+    if (len < 0  or  len > (int) sizeof(buf)-1)
+        len = sizeof(buf)-1;
+    out_put(buf, len);
+}
+
+
+/*------------------------------------------------------------------------------
+* print_details()
+*	Prints the long listing details (attributes, size, and modification
+*	time) preceding an entry pathname.
+*/
+
+static void print_details(uint64_t sz, unsigned int attr, const struct _FILETIME *ft)
+{
+    char	sbuf[40+1];
+    char	abuf[40+1];
+    char	dbuf[40+1];
+
+    s_size(sz, sbuf);
+    s_attrib(attr, abuf);
+    s_datetime(ft, dbuf);
+    out_printf("%-9s %15s %s  ", abuf, sbuf, dbuf);
+}
+
+
+/*------------------------------------------------------------------------------
+* print_prefix()
+*	Prints a compact listing prefix record for the directory prefix composed
+*	of 'drive', 'pre', and 'sep', unless it is the same as the last prefix
+*	printed.  For the front-coded format, only the part of the prefix that
+*	differs from the last prefix is printed.
+*
+* Returns
+*	True on success, or false if the prefix is too long to be printed.
+*/
+
+static bool print_prefix(const char *drive, const char *pre, const char *sep)
+{
+    size_t	n;
+    char	buf[sizeof(last_prefix)];
+
+    /* Build the full directory prefix */
+    if (strlen(drive) + strlen(pre) + strlen(sep) >= sizeof(buf))
+    {
+        fprintf(stderr, "error: Filename directory prefix is too long: %.80s%.80s...\n",
+            drive, pre);
+        return false;
+    }
+    strcpy(buf, drive);
+    strcat(buf, pre);
+    strcat(buf, sep);
+
+    if (strcmp(buf, last_prefix) == 0)
+        return true;
+
+    /* Find the leading part shared with the last prefix */
+    n = 0;
+    if (opt.o_format == FMT_FRONT)
+    {
+        while (buf[n] != '\0'  and  buf[n] == last_prefix[n])
+            n++;
+    }
+
+    /* Print the prefix record */
+    out_putc(DIRS_CHAR);
+    out_putu(n);
+    out_putc(DIRS_CHAR);
+    out_puts(buf+n);
+    out_putc('\n');
+
+    strcpy(last_prefix, buf);
+    return true;
+}
+
+
+/*------------------------------------------------------------------------------
+* json_str()
+*	Converts string 's' into the contents of a JSON string in 'buf', which
+*	must hold 6 times the length of 's' plus one bytes.  Quotes, backslashes,
+*	and control characters are escaped, and other characters are converted
+*	from the ANSI code page to UTF-8.  If the string cannot be converted,
+*	its non-ASCII bytes are escaped as "\u00XX" instead.
+*
+* Returns
+*	Length of the string in 'buf'.
+*/
+
+static size_t json_str(const char *s, char *buf)
+{
+    static const char	hex[] = "0123456789ABCDEF";
+    const unsigned char *	p;
+    char *		q = buf;
+    size_t		len;
+    bool		utf8 = false;
+    WCHAR		wloc[MAX_PATH+1];
+    char		uloc[3*MAX_PATH+1];
+    WCHAR *		w = wloc;
+    char *		u = uloc;
+
+    /* Convert the string to UTF-8, if it is not plain ASCII */
+    for (p = (const unsigned char *) s;  *p != '\0'  and  *p < 0x80;  p++)
+        ;
+    if (*p != '\0')
+    {
+        len = strlen(s);
+        if (len > MAX_PATH)
+        {
+            /* A long directory prefix, converted once per directory */
+            w = (WCHAR *) malloc((len+1) * sizeof(WCHAR));
+            u = (char *) malloc(3*len+1);
+        }
+        if (w != NULL  and  u != NULL
+            and  MultiByteToWideChar(CP_ACP, 0, s, -1, w, (int) len+1) > 0
+            and  WideCharToMultiByte(CP_UTF8, 0, w, -1, u, (int) (3*len+1),
+                NULL, NULL) > 0)
+        {
+            s = u;
+            utf8 = true;
+        }
+    }
+
+    /* Escape the characters that need it */
+    for (p = (const unsigned char *) s;  *p != '\0';  p++)
+    {
+        if (*p == '"'  or  *p == '\\')
+        {
+            *q++ = '\\';
+            *q++ = (char) *p;
+        }
+        else if (*p < ' '  or  (*p >= 0x80  and  not utf8))
+        {
+            memcpy(q, "\\u00", 4);
+            q[4] = hex[*p >> 4];
+            q[5] = hex[*p & 0xF];
+            q += 6;
+        }
+        else
+            *q++ = (char) *p;
+    }
+    *q = '\0';
+
+    if (w != wloc)
+        free(w);
+    if (u != uloc)
+        free(u);
+    return q - buf;
+}
+
+
+/*------------------------------------------------------------------------------
+* print_json_pre()
+*	Prints the path prefix composed of 'drive', 'pre', and 'sep' as part of
+*	a JSON string.  The JSON form of the prefix is kept, so that it is only
+*	converted once for all of the entries of a directory.
+*/
+
+static void print_json_pre(const char *drive, const char *pre, const char *sep)
+{
+    size_t	dlen = strlen(drive);
+    size_t	plen = strlen(pre);
+    size_t	slen = strlen(sep);
+
+    if (json_key == NULL
+        or  strncmp(json_key, drive, dlen) != 0
+        or  strncmp(json_key+dlen, pre, plen) != 0
+        or  strncmp(json_key+dlen+plen, sep, slen) != 0
+        or  json_key[dlen+plen+slen] != '\0')
+    {
+        /* Convert the new prefix */
+        free(json_key);
+        free(json_pre);
+        json_key = (char *) malloc(dlen+plen+slen+1);
+        json_pre = (char *) malloc(6*(dlen+plen+slen)+1);
+        if (json_key == NULL  or  json_pre == NULL)
+        {
+            fprintf(stderr, "%s: Out of memory\n", prog);
+            exit(RC_ERR);
+        }
+        strcpy(json_key, drive);
+        strcat(json_key, pre);
+        strcat(json_key, sep);
+        json_prelen = json_str(json_key, json_pre);
+    }
+
+    out_put(json_pre, json_prelen);
+}
+
+
+/*------------------------------------------------------------------------------
+* print_json()
+*	Prints a JSON object line for file info 'info', with path prefix parts
+*	'drive', 'pre', and 'sep'.
+*	The modification time is in seconds since 1970-01-01 00:00:00 UTC.
+*/
+
+static void print_json(const char *drive, const char *pre, const char *sep, struct _WIN32_FIND_DATAA *info, uint64_t sz)
+{
+    const struct _FILETIME *	ft = &info->ftLastWriteTime;
+    __int64			t;
+    char			abuf[40+1];
+    char			nbuf[6*MAX_PATH+1];
+
+    out_put("{\"path\":\"", 9);
+    print_json_pre(drive, pre, sep);
+    out_put(nbuf, json_str(info->cFileName, nbuf));
+
+    out_put("\",\"size\":", 9);
+    out_putu(sz);
+
+    out_put(",\"mtime\":", 9);
+    t = ((__int64)ft->dwHighDateTime << 32) + ft->dwLowDateTime;
+    t = (t - TICKS_TO_1970) / TICKS_PER_SEC;
+    if (t < 0)
+    {
+        out_putc('-');
+        t = -t;
+    }
+    out_putu((uint64_t) t);
+
+    out_put(",\"attr\":\"", 9);
+    out_puts(s_attrib(info->dwFileAttributes, abuf));
+    out_put("\"}\n", 3);
+}
+
+
+/*------------------------------------------------------------------------------
+* print_fmt()
+*	Prints file info 'info', of size 'sz', with drive prefix 'drive', path
+*	prefix 'pre', and separator 'sep' to the output, in the output format.
+*/
+
+static void print_fmt(const char *drive, const char *pre, const char *sep, struct _WIN32_FIND_DATAA *info, uint64_t sz)
+{
+    out_record();
+
+    if (opt.o_longlist)
+    {
+        /* Print detailed info */
+        print_details(sz, info->dwFileAttributes, &info->ftLastWriteTime);
+    }
+
+    /* Print the entry name */
+    if (opt.o_format == FMT_BIN)
+    {
+        const struct _FILETIME *	ft = &info->ftLastWriteTime;
+        size_t				plen;
+
+        /* Print a binary entry record */
+        plen = strlen(drive) + strlen(pre) + strlen(sep) + strlen(info->cFileName);
+        out_putle(BIN_HDRSIZE + plen, 4);
+        out_putle(sz, 8);
+        out_putle(((uint64_t)ft->dwHighDateTime << 32) + ft->dwLowDateTime, 8);
+        out_putle(info->dwFileAttributes, 4);
+        out_putle(plen, 2);
+        out_puts(drive);
+        out_puts(pre);
+        out_puts(sep);
+        out_puts(info->cFileName);
+    }
+    else if (opt.o_format == FMT_JSON)
+    {
+        /* Print a JSON object line */
+        print_json(drive, pre, sep, info, sz);
+    }
+    else if (opt.o_format == FMT_DIRS  or  opt.o_format == FMT_FRONT)
+    {
+        /* Print the name following its directory prefix record (an entry
+        whose prefix cannot be printed is left out, since its name would be
+        taken to be in the last directory printed) */
+        if (print_prefix(drive, pre, sep))
+        {
+            out_puts(info->cFileName);
+            out_putc('\n');
+        }
+    }
+    else if (opt.o_nameonly)
+    {
+        /* Print only the file name, sans prefix */
+        out_puts(info->cFileName);
+        out_putc(opt.o_nulterm ? '\0' : '\n');
+    }
+    else
+    {
+        /* Print the full file pathname */
+        out_puts(drive);
+        out_puts(pre);
+        out_puts(sep);
+        out_puts(info->cFileName);
+        out_putc(opt.o_nulterm ? '\0' : '\n');
+    }
+}
+
+
+/*------------------------------------------------------------------------------
+* sort_cmp()
+*	Compares sort records 'a' and 'b' by the '-o' sort key.
+*	Entries with equal keys are ordered by pathname.
+*
+* Returns
+*	Negative if 'a' sorts before 'b', positive if 'a' sorts after 'b',
+*	otherwise zero.
+*/
+
+static int sort_cmp(const struct SortRec *a, const struct SortRec *b)
+{
+    int		r = 0;
+
+    if (opt.o_sort == SORT_SIZE)
+        r = (a->e_size > b->e_size) - (a->e_size < b->e_size);
+    else if (opt.o_sort == SORT_MTIME)
+        r = (a->e_mtime > b->e_mtime) - (a->e_mtime < b->e_mtime);
+
+    if (opt.o_sortrev)
+        r = -r;
+
+    if (r == 0)
+    {
+        r = _stricmp(a->e_path, b->e_path);
+        if (r == 0)
+            r = strcmp(a->e_path, b->e_path);
+        if (opt.o_sortrev  and  opt.o_sort == SORT_NAME)
+            r = -r;
+    }
+    return r;
+}
+
+
+/*------------------------------------------------------------------------------
+* sort_qcmp()
+*	Compares sort record pointers for qsort().
+*/
+
+static int sort_qcmp(const void *a, const void *b)
+{
+    return sort_cmp(*(const struct SortRec * const *) a,
+        *(const struct SortRec * const *) b);
+}
+
+
+/*------------------------------------------------------------------------------
+* sort_reset()
+*	Discards the records held by sorter 's', keeping its pointer array and
+*	one arena chunk.
+*/
+
+static void sort_reset(struct Sorter *s)
+{
+    struct SortChunk *	k;
+    struct SortChunk *	next;
+
+    /* Keep the newest chunk for reuse */
+    s->s_used = s->s_max * sizeof(struct SortRec *);
+    if ((k = s->s_chunks) != NULL)
+    {
+        next = k->k_next;
+        k->k_next = NULL;
+        k->k_used = 0;
+        s->s_used += sizeof(struct SortChunk);
+
+        while ((k = next) != NULL)
+        {
+            next = k->k_next;
+            free(k);
+        }
+    }
+    s->s_nrecs = 0;
+}
+
+
+/*------------------------------------------------------------------------------
+* run_new()
+*	Creates an empty sort run, which is a temporary file.
+*
+* Returns
+*	The new run, open for writing.
+*/
+
+static struct SortRun * run_new(void)
+{
+    struct SortRun *	u;
+    char		dir[MAX_PATH+1];
+
+    u = (struct SortRun *) calloc(1, sizeof(struct SortRun));
+    if (u == NULL)
+    {
+        fprintf(stderr, "%s: Out of memory\n", prog);
+        exit(RC_ERR);
+    }
+
+    if (GetTempPathA(sizeof(dir), dir) == 0
+        or  GetTempFileNameA(dir, "vfs", 0, u->u_name) == 0
+        or  (u->u_fp = fopen(u->u_name, "w+b")) == NULL)
+    {
+        fprintf(stderr, "%s: Cannot create a temporary sort file\n", prog);
+        exit(RC_ERR);
+    }
+
+    DL(printf("|run_new: '%s'\n", u->u_name));
+    return u;
+}
+
+
+/*------------------------------------------------------------------------------
+* run_write()
+*	Writes sort record 'r' to the end of sort run 'u'.
+*/
+
+static void run_write(struct SortRun *u, const struct SortRec *r)
+{
+    if (fwrite(r, SORT_RECHDR + r->e_len + 1, 1, u->u_fp) != 1)
+    {
+        fprintf(stderr, "%s: Cannot write temporary sort file '%s'\n",
+            prog, u->u_name);
+        exit(RC_ERR);
+    }
+}
+
+
+/*------------------------------------------------------------------------------
+* run_next()
+*	Reads the next record of sort run 'u' into 'u->u_rec', which is set to
+*	null at the end of the run.
+*/
+
+static void run_next(struct SortRun *u)
+{
+    struct SortRec *	r;
+
+    if (u->u_fp == NULL)
+    {
+        /* Records held in memory */
+        u->u_rec = (u->u_n > 0 ? *u->u_recs++ : NULL);
+        if (u->u_n > 0)
+            u->u_n--;
+        return;
+    }
+
+    /* Records read from the run file */
+    r = u->u_buf;
+    u->u_rec = NULL;
+    if (fread(r, SORT_RECHDR, 1, u->u_fp) != 1)
+        return;
+    if (r->e_len >= SORT_PATHMAX
+        or  fread(r->e_path, r->e_len + 1, 1, u->u_fp) != 1)
+    {
+        fprintf(stderr, "%s: Cannot read temporary sort file '%s'\n",
+            prog, u->u_name);
+        exit(RC_ERR);
+    }
+    u->u_rec = r;
+}
+
+
+/*------------------------------------------------------------------------------
+* run_free()
+*	Closes, removes, and deallocates sort run 'u'.
+*/
+
+static void run_free(struct SortRun *u)
+{
+    if (u->u_fp != NULL)
+    {
+        fclose(u->u_fp);
+        remove(u->u_name);
+    }
+    free(u->u_buf);
+    free(u);
+}
+
+
+/*------------------------------------------------------------------------------
+* run_add()
+*	Adds sort run 'u' to the end of the list of spilled runs.
+*/
+
+static void run_add(struct SortRun *u)
+{
+    EnterCriticalSection(&runs.l_lock);
+    u->u_next = NULL;
+    if (runs.l_last == NULL)
+        runs.l_first = u;
+    else
+        runs.l_last->u_next = u;
+    runs.l_last = u;
+    runs.l_count++;
+    LeaveCriticalSection(&runs.l_lock);
+}
+
+
+/*------------------------------------------------------------------------------
+* sort_spill()
+*	Sorts the records held by sorter 's' and writes them to a new sort run,
+*	freeing their memory.
+*/
+
+static void sort_spill(struct Sorter *s)
+{
+    struct SortRun *	u;
+    size_t		i;
+
+    DL(printf("|sort_spill: %lu records\n", (unsigned long) s->s_nrecs));
+
+    qsort(s->s_recs, s->s_nrecs, sizeof(struct SortRec *), sort_qcmp);
+
+    u = run_new();
+    for (i = 0;  i < s->s_nrecs;  i++)
+        run_write(u, s->s_recs[i]);
+    if (fflush(u->u_fp) != 0)
+    {
+        fprintf(stderr, "%s: Cannot write temporary sort file '%s'\n",
+            prog, u->u_name);
+        exit(RC_ERR);
+    }
+
+    run_add(u);
+    sort_reset(s);
+}
+
+
+/*------------------------------------------------------------------------------
+* sort_fill()
+*	Fills in sort record 'r' for an entry with file info 'info', of size
+*	'sz', and pathname 'drive', 'pre', 'sep', and file name.
+*	The record must have room for the whole pathname.
+*/
+
+static void sort_fill(struct SortRec *r, const char *drive, const char *pre, const char *sep, struct _WIN32_FIND_DATAA *info, uint64_t sz)
+{
+    r->e_size = sz;
+    r->e_mtime = ((uint64_t)info->ftLastWriteTime.dwHighDateTime << 32)
+        + info->ftLastWriteTime.dwLowDateTime;
+    r->e_attr = info->dwFileAttributes;
+    strcpy(r->e_path, drive);
+    strcat(r->e_path, pre);
+    strcat(r->e_path, sep);
+    r->e_prelen = (unsigned int) strlen(r->e_path);
+    strcat(r->e_path, info->cFileName);
+    r->e_len = r->e_prelen + (unsigned int) strlen(info->cFileName);
+}
+
+
+/*------------------------------------------------------------------------------
+* sort_add()
+*	Adds an entry with file info 'info', of size 'sz', and pathname
+*	'drive', 'pre', 'sep', and file name to sorter 's'.
+*	The records are spilled to a sort run if the sorter holds more than its
+*	share of the sort memory cap.  An entry whose pathname is too long to
+*	be sorted is reported and left out.
+*/
+
+static void sort_add(struct Sorter *s, const char *drive, const char *pre, const char *sep, struct _WIN32_FIND_DATAA *info, uint64_t sz)
+{
+    struct SortRec *	r;
+    struct SortChunk *	k;
+    size_t		plen;
+    size_t		len;
+    size_t		need;
+    uint64_t		cap;
+
+    plen = strlen(drive) + strlen(pre) + strlen(sep);
+    len = plen + strlen(info->cFileName);
+    if (len >= SORT_PATHMAX)
+    {
+        fprintf(stderr, "error: Filename is too long to be sorted: %.80s%.80s...\n",
+            drive, pre);
+        omitted = 1;
+        return;
+    }
+    need = (SORT_RECHDR + len + 1 + 7) & ~(size_t) 7;
+
+    /* Spill the held records if this one would exceed the memory cap */
+    cap = opt.o_sortmem / (opt.o_jobs > 1 ? opt.o_jobs : 1);
+    if (cap < SORT_MINCAP)
+        cap = SORT_MINCAP;
+    if (opt.o_sort != SORT_DIR  and  s->s_nrecs > 0  and  s->s_used + need > cap)
+        sort_spill(s);
+
+    /* Grow the record pointer array */
+    if (s->s_nrecs >= s->s_max)
+    {
+        size_t		max;
+        struct SortRec **	p;
+
+        max = (s->s_max > 0 ? s->s_max*2 : 1024);
+        p = (struct SortRec **) realloc(s->s_recs, max * sizeof(*p));
+        if (p == NULL)
+        {
+            fprintf(stderr, "%s: Out of memory\n", prog);
+            exit(RC_ERR);
+        }
+        s->s_used += (max - s->s_max) * sizeof(*p);
+        s->s_recs = p;
+        s->s_max = max;
+    }
+
+    /* Allocate the record from the arena */
+    k = s->s_chunks;
+    if (k == NULL  or  k->k_used + need > SORT_CHUNK)
+    {
+        k = (struct SortChunk *) malloc(sizeof(struct SortChunk));
+        if (k == NULL)
+        {
+            fprintf(stderr, "%s: Out of memory\n", prog);
+            exit(RC_ERR);
+        }
+        k->k_next = s->s_chunks;
+        k->k_used = 0;
+        s->s_chunks = k;
+        s->s_used += sizeof(struct SortChunk);
+    }
+    r = (struct SortRec *) ((char *) k->k_data + k->k_used);
+    k->k_used += need;
+
+    sort_fill(r, drive, pre, sep, info, sz);
+    s->s_recs[s->s_nrecs++] = r;
+}
+
+
+/*------------------------------------------------------------------------------
+* sort_join()
+*	Moves the records held by sorter 'from' to sorter 'to'.
+*/
+
+static void sort_join(struct Sorter *to, struct Sorter *from)
+{
+    struct SortChunk *	k;
+
+    if (to->s_nrecs + from->s_nrecs > to->s_max)
+    {
+        size_t		max;
+        struct SortRec **	p;
+
+        max = to->s_nrecs + from->s_nrecs;
+        p = (struct SortRec **) realloc(to->s_recs, max * sizeof(*p));
+        if (p == NULL)
+        {
+            fprintf(stderr, "%s: Out of memory\n", prog);
+            exit(RC_ERR);
+        }
+        to->s_used += (max - to->s_max) * sizeof(*p);
+        to->s_recs = p;
+        to->s_max = max;
+    }
+
+    memcpy(to->s_recs + to->s_nrecs, from->s_recs,
+        from->s_nrecs * sizeof(struct SortRec *));
+    to->s_nrecs += from->s_nrecs;
+
+    while ((k = from->s_chunks) != NULL)
+    {
+        from->s_chunks = k->k_next;
+        k->k_next = to->s_chunks;
+        to->s_chunks = k;
+        to->s_used += sizeof(struct SortChunk);
+    }
+
+    free(from->s_recs);
+    memset(from, 0, sizeof(*from));
+}
+
+
+/*------------------------------------------------------------------------------
+* sort_emit()
+*	Prints sort record 'r' to the output.
+*/
+
+static void sort_emit(const struct SortRec *r)
+{
+    struct _WIN32_FIND_DATAA	fd;
+    char			pre[SORT_PATHMAX];
+
+    memset(&fd, 0, sizeof(fd));
+    fd.dwFileAttributes = r->e_attr;
+    fd.nFileSizeHigh = (DWORD) (r->e_size >> 32);
+    fd.nFileSizeLow =  (DWORD) r->e_size;
+    fd.ftLastWriteTime.dwHighDateTime = (DWORD) (r->e_mtime >> 32);
+    fd.ftLastWriteTime.dwLowDateTime =  (DWORD) r->e_mtime;
+    strncpy(fd.cFileName, r->e_path + r->e_prelen, sizeof(fd.cFileName)-1);
+
+    memcpy(pre, r->e_path, r->e_prelen);
+    pre[r->e_prelen] = '\0';
+
+    print_fmt("", pre, "", &fd, r->e_size);
+}
+
+
+/*------------------------------------------------------------------------------
+* sort_merge()
+*	Merges the 'n' sort runs 'v', writing the merged records to sort run
+*	'out', or printing them to the output if 'out' is null.
+*	The runs are merged by keeping them in a heap ordered by their current
+*	records.
+*/
+
+static void sort_merge(struct SortRun **v, int n, struct SortRun *out)
+{
+    struct SortRun *	h[SORT_FANIN];
+    struct SortRun *	u;
+    int			i, j, m;
+
+    /* Read the first record of each run */
+    m = 0;
+    for (i = 0;  i < n;  i++)
+    {
+        u = v[i];
+        if (u->u_fp != NULL)
+        {
+            rewind(u->u_fp);
+            if (u->u_buf == NULL)
+            {
+                u->u_buf = (struct SortRec *) malloc(SORT_RECHDR + SORT_PATHMAX);
+                if (u->u_buf == NULL)
+                {
+                    fprintf(stderr, "%s: Out of memory\n", prog);
+                    exit(RC_ERR);
+                }
+            }
+        }
+
+        run_next(u);
+        if (u->u_rec != NULL)
+            h[m++] = u;
+    }
+
+    /* Build the heap */
+    for (i = m/2 - 1;  i >= 0;  i--)
+    {
+        u = h[i];
+        for (j = i;  2*j+1 < m;  )
+        {
+            int		c = 2*j+1;
+
+            if (c+1 < m  and  sort_cmp(h[c+1]->u_rec, h[c]->u_rec) < 0)
+                c++;
+            if (sort_cmp(h[c]->u_rec, u->u_rec) >= 0)
+                break;
+            h[j] = h[c];
+            j = c;
+        }
+        h[j] = u;
+    }
+
+    /* Take the least record until all of the runs are exhausted */
+    while (m > 0)
+    {
+        u = h[0];
+        if (out != NULL)
+            run_write(out, u->u_rec);
+        else
+            sort_emit(u->u_rec);
+
+        run_next(u);
+        if (u->u_rec == NULL)
+        {
+            if (--m == 0)
+                break;
+            u = h[m];
+        }
+
+        for (j = 0;  2*j+1 < m;  )
+        {
+            int		c = 2*j+1;
+
+            if (c+1 < m  and  sort_cmp(h[c+1]->u_rec, h[c]->u_rec) < 0)
+                c++;
+            if (sort_cmp(h[c]->u_rec, u->u_rec) >= 0)
+                break;
+            h[j] = h[c];
+            j = c;
+        }
+        h[j] = u;
+    }
+}
+
+
+/*------------------------------------------------------------------------------
+* sort_term()
+*	Removes any remaining sort runs.
+*/
+
+static void sort_term(void)
+{
+    struct SortRun *	u;
+
+    while ((u = runs.l_first) != NULL)
+    {
+        runs.l_first = u->u_next;
+        run_free(u);
+    }
+    runs.l_last = NULL;
+    runs.l_count = 0;
+}
+
+
+/*------------------------------------------------------------------------------
+* sort_print()
+*	Prints the entries collected by the last search, in sorted order.
+*	If any records were spilled to sort runs, the runs are merged together
+*	with the records still held in memory, at most SORT_FANIN runs at a
+*	time, and are then removed.
+*/
+
+static void sort_print(void)
+{
+    struct SortRun *	v[SORT_FANIN];
+    struct SortRun	mem;
+    struct SortRun *	u;
+    size_t		i;
+    int			n;
+
+    qsort(sorter.s_recs, sorter.s_nrecs, sizeof(struct SortRec *), sort_qcmp);
+
+    if (runs.l_first == NULL)
+    {
+        /* All of the records are held in memory */
+        for (i = 0;  i < sorter.s_nrecs;  i++)
+            sort_emit(sorter.s_recs[i]);
+        sort_reset(&sorter);
+        return;
+    }
+
+    /* Merge the oldest runs into longer ones, until few enough remain */
+    while (runs.l_count > SORT_FANIN-1)
+    {
+        for (n = 0;  n < SORT_FANIN;  n++)
+        {
+            v[n] = runs.l_first;
+            runs.l_first = v[n]->u_next;
+        }
+        runs.l_count -= SORT_FANIN;
+        if (runs.l_first == NULL)
+            runs.l_last = NULL;
+
+        DL(printf("|sort_print: merge %d of %d runs\n",
+            SORT_FANIN, runs.l_count + SORT_FANIN));
+
+        u = run_new();
+        sort_merge(v, n, u);
+        for (n = 0;  n < SORT_FANIN;  n++)
+            run_free(v[n]);
+        run_add(u);
+    }
+
+    /* Merge the remaining runs and the held records to the output */
+    memset(&mem, 0, sizeof(mem));
+    mem.u_recs = sorter.s_recs;
+    mem.u_n = sorter.s_nrecs;
+    v[0] = &mem;
+    n = 1;
+    for (u = runs.l_first;  u != NULL;  u = u->u_next)
+        v[n++] = u;
+
+    sort_merge(v, n, NULL);
+
+    sort_term();
+    sort_reset(&sorter);
+}
+
+
+/*------------------------------------------------------------------------------
+* name_cmp()
+*	Compares the file names of sort records 'a' and 'b', ignoring case,
+*	starting at name character 'depth'.  Names that differ only in case
+*	are ordered by their characters.
+*/
+
+static int name_cmp(const struct SortRec *a, const struct SortRec *b, size_t depth)
+{
+    const unsigned char *	p;
+    const unsigned char *	q;
+
+    p = (const unsigned char *) a->e_path + a->e_prelen + depth;
+    q = (const unsigned char *) b->e_path + b->e_prelen + depth;
+    while (sort_fold[*p] == sort_fold[*q]  and  *p != '\0')
+        p++, q++;
+
+    if (sort_fold[*p] != sort_fold[*q])
+        return (sort_fold[*p] < sort_fold[*q] ? -1 : +1);
+    return strcmp(a->e_path + a->e_prelen, b->e_path + b->e_prelen);
+}
+
+
+/*------------------------------------------------------------------------------
+* name_isort()
+*	Sorts the 'n' sort records 'v' by file name, ignoring case, where the
+*	names are known to be equal up to name character 'depth'.
+*	This is an insertion sort, for a few records.
+*/
+
+static void name_isort(struct SortRec **v, size_t n, size_t depth)
+{
+    size_t		i, j;
+
+    for (i = 1;  i < n;  i++)
+    {
+        struct SortRec *	r = v[i];
+
+        for (j = i;  j > 0  and  name_cmp(v[j-1], r, depth) > 0;  j--)
+            v[j] = v[j-1];
+        v[j] = r;
+    }
+}
+
+
+/*------------------------------------------------------------------------------
+* radix_sort()
+*	Sorts the 'n' sort records 'v' by file name, ignoring case, where the
+*	names are known to be equal up to name character 'depth'.
+*	This is an MSD radix sort on the folded name characters, which
+*	distributes the records into 'tmp' by the character at 'depth' (saved
+*	in 'key', so that each record is read only once per pass), then sorts
+*	each bucket on the following characters.  Small buckets are sorted by
+*	insertion.
+*/
+
+static void radix_sort(struct SortRec **v, struct SortRec **tmp, unsigned char *key, size_t n, size_t depth)
+{
+    unsigned int	cnt[256];
+    size_t		i, j;
+
+    for (;;)
+    {
+        if (n < RADIX_MIN)
+        {
+            name_isort(v, n, depth);
+            return;
+        }
+
+        /* Count the records having each folded character at 'depth' */
+        memset(cnt, 0, sizeof(cnt));
+        for (i = 0;  i < n;  i++)
+        {
+            const struct SortRec *	r = v[i];
+
+            key[i] = sort_fold[(unsigned char) r->e_path[r->e_prelen + depth]];
+            cnt[key[i]]++;
+        }
+
+        if (cnt[key[0]] < n)
+            break;
+
+        /* All of the names have the same character at 'depth' */
+        if (key[0] == '\0')
+        {
+            name_isort(v, n, depth);
+            return;
+        }
+        depth++;
+    }
+
+    /* Distribute the records into buckets */
+    {
+        size_t		pos[256];
+        size_t		p = 0;
+
+        for (i = 0;  i < 256;  i++)
+        {
+            pos[i] = p;
+            p += cnt[i];
+        }
+        for (i = 0;  i < n;  i++)
+            tmp[pos[key[i]]++] = v[i];
+        memcpy(v, tmp, n * sizeof(struct SortRec *));
+    }
+
+    /* Sort each bucket on the following characters */
+    name_isort(v, cnt[0], depth);
+    j = cnt[0];
+    for (i = 1;  i < 256;  i++)
+    {
+        if (cnt[i] > 1)
+            radix_sort(v + j, tmp, key, cnt[i], depth+1);
+        j += cnt[i];
+    }
+}
+
+
+/*------------------------------------------------------------------------------
+* sort_dir()
+*	Prints the entries of one directory collected by sorter 's', sorted by
+*	file name, then discards them.
+*/
+
+static void sort_dir(struct Sorter *s)
+{
+    struct SortRec **	tmp;
+    unsigned char *	key;
+    size_t		i;
+
+    if (s->s_nrecs > 1)
+    {
+        tmp = (struct SortRec **) malloc(s->s_nrecs * sizeof(*tmp));
+        key = (unsigned char *) malloc(s->s_nrecs);
+        if (tmp == NULL  or  key == NULL)
+        {
+            fprintf(stderr, "%s: Out of memory\n", prog);
+            exit(RC_ERR);
+        }
+
+        radix_sort(s->s_recs, tmp, key, s->s_nrecs, 0);
+        free(key);
+        free(tmp);
+    }
+
+    for (i = 0;  i < s->s_nrecs;  i++)
+        sort_emit(s->s_recs[opt.o_sortrev ? s->s_nrecs-1 - i : i]);
+
+    sort_reset(s);
+}
+
+
+/*------------------------------------------------------------------------------
+* top_sift()
+*	Moves record 'r' down from position 'j' of the heap of top entries 't'
+*	to its place.
+*/
+
+static void top_sift(struct TopHeap *t, size_t j, struct SortRec *r)
+{
+    struct SortRec **	h = t->t_recs;
+    size_t		c;
+
+    while ((c = 2*j+1) < t->t_n)
+    {
+        if (c+1 < t->t_n  and  sort_cmp(h[c+1], h[c]) > 0)
+            c++;
+        if (sort_cmp(h[c], r) <= 0)
+            break;
+        h[j] = h[c];
+        j = c;
+    }
+    h[j] = r;
+}
+
+
+/*------------------------------------------------------------------------------
+* top_add()
+*	Adds a copy of sort record 'r' to the heap of top entries 't', if it
+*	is one of the 'opt.o_topn' best entries seen so far.
+*	The heap is ordered so that the worst of the entries it holds is at the
+*	root, which is replaced by any better entry once the heap is full.
+*/
+
+static void top_add(struct TopHeap *t, const struct SortRec *r)
+{
+    struct SortRec *	p;
+    size_t		sz;
+    size_t		j;
+
+    /* Reject the entry if it is no better than the worst one */
+    if (t->t_n == opt.o_topn  and  sort_cmp(r, t->t_recs[0]) >= 0)
+        return;
+
+    sz = SORT_RECHDR + r->e_len + 1;
+    if (t->t_n == opt.o_topn)
+    {
+        /* Replace the worst entry */
+        p = (struct SortRec *) realloc(t->t_recs[0], sz);
+        if (p == NULL)
+        {
+            fprintf(stderr, "%s: Out of memory\n", prog);
+            exit(RC_ERR);
+        }
+        memcpy(p, r, sz);
+        top_sift(t, 0, p);
+        return;
+    }
+
+    /* Grow the heap */
+    if (t->t_n >= t->t_max)
+    {
+        size_t			max;
+        struct SortRec **	h;
+
+        max = (t->t_max > 0 ? t->t_max*2 : 64);
+        if (max > opt.o_topn)
+            max = opt.o_topn;
+        h = (struct SortRec **) realloc(t->t_recs, max * sizeof(*h));
+        if (h == NULL)
+        {
+            fprintf(stderr, "%s: Out of memory\n", prog);
+            exit(RC_ERR);
+        }
+        t->t_recs = h;
+        t->t_max = max;
+    }
+
+    p = (struct SortRec *) malloc(sz);
+    if (p == NULL)
+    {
+        fprintf(stderr, "%s: Out of memory\n", prog);
+        exit(RC_ERR);
+    }
+    memcpy(p, r, sz);
+
+    /* Move the new entry up to its place */
+    for (j = t->t_n++;  j > 0  and  sort_cmp(t->t_recs[(j-1)/2], p) < 0;  j = (j-1)/2)
+        t->t_recs[j] = t->t_recs[(j-1)/2];
+    t->t_recs[j] = p;
+}
+
+
+/*------------------------------------------------------------------------------
+* top_entry()
+*	Adds an entry with file info 'info', of size 'sz', and pathname
+*	'drive', 'pre', 'sep', and file name to the heap of top entries 't'.
+*/
+
+static void top_entry(struct TopHeap *t, const char *drive, const char *pre, const char *sep, struct _WIN32_FIND_DATAA *info, uint64_t sz)
+{
+    uint64_t		buf[(SORT_RECHDR + SORT_PATHMAX)/sizeof(uint64_t) + 1];
+
+    if (strlen(drive) + strlen(pre) + strlen(sep) + strlen(info->cFileName)
+        >= SORT_PATHMAX)
+        return;
+
+    sort_fill((struct SortRec *) buf, drive, pre, sep, info, sz);
+    top_add(t, (struct SortRec *) buf);
+}
+
+
+/*------------------------------------------------------------------------------
+* top_join()
+*	Adds the top entries held by heap 'from' to heap 'to', and empties
+*	'from'.
+*/
+
+static void top_join(struct TopHeap *to, struct TopHeap *from)
+{
+    size_t		i;
+
+    for (i = 0;  i < from->t_n;  i++)
+    {
+        top_add(to, from->t_recs[i]);
+        free(from->t_recs[i]);
+    }
+
+    free(from->t_recs);
+    memset(from, 0, sizeof(*from));
+}
+
+
+/*------------------------------------------------------------------------------
+* top_print()
+*	Prints the top entries found by the last search, best first, then
+*	discards them.
+*/
+
+static void top_print(void)
+{
+    size_t		i;
+
+    qsort(top.t_recs, top.t_n, sizeof(struct SortRec *), sort_qcmp);
+
+    for (i = 0;  i < top.t_n;  i++)
+    {
+        sort_emit(top.t_recs[i]);
+        free(top.t_recs[i]);
+    }
+    top.t_n = 0;
+}
+
+
+/*------------------------------------------------------------------------------
+* group_find()
+*	Finds the slot of group map 'm' for key 'key', of 'len' bytes and hash
+*	value 'h', which is either the key's slot or the empty slot where it
+*	belongs.
+*/
+
+static struct Group * group_find(struct GroupMap *m, const char *key, unsigned int len, unsigned int h)
+{
+    struct Group *	g;
+    size_t		i;
+
+    for (i = h & (m->m_size-1);  ;  i = (i+1) & (m->m_size-1))
+    {
+        g = &m->m_slots[i];
+        if (g->g_key == NULL)
+            return g;
+        if (g->g_hash == h  and  g->g_keylen == len
+            and  memcmp(g->g_key, key, len) == 0)
+            return g;
+    }
+}
+
+
+/*------------------------------------------------------------------------------
+* group_add()
+*	Adds 'n' entries totalling 'bytes' bytes to the totals of key 'key', of
+*	'len' bytes, in group map 'm'.
+*	The key is copied into the map only when it is first added.
+*/
+
+static void group_add(struct GroupMap *m, const char *key, unsigned int len, uint64_t n, uint64_t bytes)
+{
+    struct Group *	g;
+    unsigned int	h;
+    unsigned int	i;
+
+    /* Hash the key (FNV-1a) */
+    h = 2166136261u;
+    for (i = 0;  i < len;  i++)
+        h = (h ^ (unsigned char) key[i]) * 16777619u;
+
+    /* Grow the map when it is 3/4 full */
+    if ((m->m_n+1)*4 > m->m_size*3)
+    {
+        struct Group *	old = m->m_slots;
+        size_t		oldsize = m->m_size;
+        size_t		j;
+
+        m->m_size = (oldsize > 0 ? oldsize*2 : 64);
+        m->m_slots = (struct Group *) calloc(m->m_size, sizeof(struct Group));
+        if (m->m_slots == NULL)
+        {
+            fprintf(stderr, "%s: Out of memory\n", prog);
+            exit(RC_ERR);
+        }
+
+        for (j = 0;  j < oldsize;  j++)
+        {
+            if (old[j].g_key != NULL)
+                *group_find(m, old[j].g_key, old[j].g_keylen, old[j].g_hash) = old[j];
+        }
+        free(old);
+    }
+
+    g = group_find(m, key, len, h);
+    if (g->g_key == NULL)
+    {
+        struct SortChunk *	k = m->m_keys;
+        char *			p;
+
+        /* Copy the new key into the key arena */
+        if (k == NULL  or  k->k_used + len + 1 > SORT_CHUNK)
+        {
+            k = (struct SortChunk *) malloc(sizeof(struct SortChunk));
+            if (k == NULL)
+            {
+                fprintf(stderr, "%s: Out of memory\n", prog);
+                exit(RC_ERR);
+            }
+            k->k_next = m->m_keys;
+            k->k_used = 0;
+            m->m_keys = k;
+        }
+        p = (char *) k->k_data + k->k_used;
+        k->k_used += len + 1;
+        memcpy(p, key, len);
+        p[len] = '\0';
+
+        g->g_key = p;
+        g->g_keylen = len;
+        g->g_hash = h;
+        m->m_n++;
+    }
+
+    g->g_count += n;
+    g->g_bytes += bytes;
+}
+
+
+/*------------------------------------------------------------------------------
+* group_entry()
+*	Adds an entry with file info 'info', of size 'sz', and pathname
+*	'drive', 'pre', 'sep', and file name to group map 'm', under its
+*	'-group' key.
+*/
+
+static void group_entry(struct GroupMap *m, const char *drive, const char *pre, const char *sep, struct _WIN32_FIND_DATAA *info, uint64_t sz)
+{
+    const char *	key = "";
+    unsigned int	len = 0;
+    char		buf[MAX_PATH+1];
+    uint64_t		sd[4096/sizeof(uint64_t)];	/* Security info */
+
+    switch (opt.o_groupkey)
+    {
+    case GROUP_EXT:
+        {
+            const char *	ext;
+            char *		p;
+
+            /* Extension, lowercase, without its '.' */
+            ext = strrchr(info->cFileName, '.');
+            if (ext != NULL  and  ext != info->cFileName)
+            {
+                for (p = buf;  *++ext != '\0'  and  p < buf+MAX_PATH;  p++)
+                    *p = (char) tolower((unsigned char) *ext);
+                key = buf;
+                len = (unsigned int) (p - buf);
+            }
+        }
+        break;
+
+    case GROUP_DEPTH:
+        /* Subdirectory depth */
+        len = sprintf(buf, "%d", dir_depth);
+        key = buf;
+        break;
+
+    case GROUP_OWNER:
+        {
+            char		path[16*1024+1];
+            DWORD		need;
+            PSID		sid;
+            BOOL		dfl;
+
+            /* Owner security ID */
+            if (strlen(drive) + strlen(pre) + strlen(sep)
+                + strlen(info->cFileName) >= sizeof(path))
+                break;
+            strcpy(path, drive);
+            strcat(path, pre);
+            strcat(path, sep);
+            strcat(path, info->cFileName);
+
+            if (GetFileSecurityA(path, OWNER_SECURITY_INFORMATION,
+                    (PSECURITY_DESCRIPTOR) sd, sizeof(sd), &need)
+                and  GetSecurityDescriptorOwner((PSECURITY_DESCRIPTOR) sd,
+                    &sid, &dfl)
+                and  sid != NULL)
+            {
+                key = (const char *) sid;
+                len = GetLengthSid(sid);
+            }
+        }
+        break;
+    }
+
+    group_add(m, key, len, 1, sz);
+}
+
+
+/*------------------------------------------------------------------------------
+* group_join()
+*	Adds the totals held by group map 'from' to group map 'to', and empties
+*	'from'.
+*/
+
+static void group_join(struct GroupMap *to, struct GroupMap *from)
+{
+    struct SortChunk *	k;
+    size_t		i;
+
+    for (i = 0;  i < from->m_size;  i++)
+    {
+        const struct Group *	g = &from->m_slots[i];
+
+        if (g->g_key != NULL)
+            group_add(to, g->g_key, g->g_keylen, g->g_count, g->g_bytes);
+    }
+
+    while ((k = from->m_keys) != NULL)
+    {
+        from->m_keys = k->k_next;
+        free(k);
+    }
+    free(from->m_slots);
+    memset(from, 0, sizeof(*from));
+}
+
+
+/*------------------------------------------------------------------------------
+* group_cmp()
+*	Compares '-group' totals for qsort(), by descending bytes, then by
+*	descending entries, then by key.
+*/
+
+static int group_cmp(const void *a, const void *b)
+{
+    const struct Group *	p = *(const struct Group * const *) a;
+    const struct Group *	q = *(const struct Group * const *) b;
+
+    if (p->g_bytes != q->g_bytes)
+        return (p->g_bytes > q->g_bytes ? -1 : +1);
+    if (p->g_count != q->g_count)
+        return (p->g_count > q->g_count ? -1 : +1);
+    if (p->g_keylen != q->g_keylen)
+        return (p->g_keylen < q->g_keylen ? -1 : +1);
+    return memcmp(p->g_key, q->g_key, p->g_keylen);
+}
+
+
+/*------------------------------------------------------------------------------
+* group_print()
+*	Prints the '-group' totals found by the last search, by descending
+*	bytes, then empties the group map.
+*/
+
+static void group_print(void)
+{
+    struct Group **	v;
+    struct SortChunk *	k;
+    size_t		i, n;
+    char		c_ent[30+1];
+    char		c_byte[30+1];
+    char		name[2*256+1+1];
+
+    v = (struct Group **) malloc((groups.m_n+1) * sizeof(*v));
+    if (v == NULL)
+    {
+        fprintf(stderr, "%s: Out of memory\n", prog);
+        exit(RC_ERR);
+    }
+
+    for (i = n = 0;  i < groups.m_size;  i++)
+    {
+        if (groups.m_slots[i].g_key != NULL)
+            v[n++] = &groups.m_slots[i];
+    }
+    qsort(v, n, sizeof(*v), group_cmp);
+
+    if (opt.o_summary)
+        out_putc('\n');
+    out_printf("          Bytes      Entries  %s\n",
+        (opt.o_groupkey == GROUP_EXT ? "Extension" :
+        opt.o_groupkey == GROUP_DEPTH ? "Depth" : "Owner"));
+
+    for (i = 0;  i < n;  i++)
+    {
+        const struct Group *	g = v[i];
+        const char *		s = g->g_key;
+
+        if (g->g_keylen == 0)
+            s = "(none)";
+        else if (opt.o_groupkey == GROUP_EXT)
+        {
+            name[0] = '.';
+            strncpy(name+1, g->g_key, sizeof(name)-2);
+            name[sizeof(name)-1] = '\0';
+            s = name;
+        }
+        else if (opt.o_groupkey == GROUP_OWNER)
+        {
+            char		acct[256+1];
+            DWORD		alen = sizeof(acct);
+            DWORD		dlen = 256+1;
+            SID_NAME_USE	use;
+            char *		sidstr;
+
+            /* Look up the owner's account name */
+            if (LookupAccountSidA(NULL, (PSID) g->g_key, acct, &alen,
+                    name, &dlen, &use))
+            {
+                if (name[0] != '\0')
+                    strcat(name, SEP_STR);
+                strcat(name, acct);
+            }
+            else if (ConvertSidToStringSidA((PSID) g->g_key, &sidstr))
+            {
+                strncpy(name, sidstr, sizeof(name)-1);
+                name[sizeof(name)-1] = '\0';
+                LocalFree(sidstr);
+            }
+            else
+                strcpy(name, "?");
+            s = name;
+        }
+
+        s_size(g->g_bytes, c_byte);
+        s_size(g->g_count, c_ent);
+        out_printf("%15s %12s  %s\n", c_byte, c_ent, s);
+    }
+
+    free(v);
+
+    /* Empty the map */
+    while ((k = groups.m_keys) != NULL)
+    {
+        groups.m_keys = k->k_next;
+        free(k);
+    }
+    free(groups.m_slots);
+    memset(&groups, 0, sizeof(groups));
+}
+
+
+/*------------------------------------------------------------------------------
+* hist_add()
+*	Adds an entry of size 'sz' and modification time 'ft' to the size and
+*	age histograms.
+*/
+
+static const struct
+{
+    __int64		a_secs;		/* Age limit, in seconds	*/
+    const char *	a_name;		/* Bucket name			*/
+}			hist_ages[HIST_AGES] =
+{
+    { 0,			"future"	},
+    { 60*60,			"< 1 hour"	},
+    { 24*60*60,			"< 1 day"	},
+    { 7*24*60*60,		"< 1 week"	},
+    { 30*24*60*60,		"< 30 days"	},
+    { 90*24*60*60,		"< 90 days"	},
+    { 365*24*60*60LL,		"< 1 year"	},
+    { 2*365*24*60*60LL,		"< 2 years"	},
+    { 5*365*24*60*60LL,		"< 5 years"	},
+    { 0,			"older"		}
+};
+
+static void hist_add(uint64_t sz, const struct _FILETIME *ft)
+{
+    __int64		age;
+    uint64_t		v;
+    int			i;
+
+    /* Size bucket k holds sizes of 2^(k-1) to 2^k-1 bytes */
+    for (i = 0, v = sz;  v != 0;  i++)
+        v >>= 1;
+    count.c_sizes[i]++;
+    count.c_sizebytes[i] += sz;
+
+    /* Age bucket */
+    age = (__int64) (opt.o_now
+        - (((uint64_t)ft->dwHighDateTime << 32) + ft->dwLowDateTime));
+    if (age < 0)
+        i = 0;
+    else
+    {
+        age /= TICKS_PER_SEC;
+        for (i = 1;  i < HIST_AGES-1;  i++)
+            if (age < hist_ages[i].a_secs)
+                break;
+    }
+    count.c_ages[i]++;
+    count.c_agebytes[i] += sz;
+}
+
+
+/*------------------------------------------------------------------------------
+* hist_print()
+*	Prints the size and age histograms of count totals 'c'.
+*/
+
+static void hist_print(const struct Count *c)
+{
+    uint64_t		tot = 0;
+    int			i, lo, hi;
+    char		c_ent[30+1];
+    char		c_byte[30+1];
+    char		c_lim[30+1];
+
+    for (i = 0;  i < HIST_AGES;  i++)
+        tot += c->c_ages[i];
+    if (tot == 0)
+        tot = 1;
+
+    /* Print the nonempty range of size buckets */
+    for (lo = 0;  lo < HIST_SIZES-1  and  c->c_sizes[lo] == 0;  lo++)
+        ;
+    for (hi = HIST_SIZES-1;  hi > lo  and  c->c_sizes[hi] == 0;  hi--)
+        ;
+
+    if (opt.o_summary)
+        out_putc('\n');
+    out_printf(" Size (from)      Entries              Bytes     %%\n");
+    for (i = lo;  i <= hi;  i++)
+    {
+        uint64_t	lim;
+        const char *	u = "";
+
+        /* Lower limit of the bucket, scaled to k/m/g/t */
+        lim = (i == 0 ? 0 : 1ULL << (i-1));
+        if (i > 40)
+            lim >>= 40, u = "t";
+        else if (i > 30)
+            lim >>= 30, u = "g";
+        else if (i > 20)
+            lim >>= 20, u = "m";
+        else if (i > 10)
+            lim >>= 10, u = "k";
+        s_size(lim, c_lim);
+        strcat(c_lim, u);
+
+        s_size(c->c_sizes[i], c_ent);
+        s_size(c->c_sizebytes[i], c_byte);
+        out_printf(" %10s %12s %18s %5.1f\n",
+            c_lim, c_ent, c_byte, 100.0 * c->c_sizes[i] / tot);
+    }
+
+    out_printf("\n Age              Entries              Bytes     %%\n");
+    for (i = 0;  i < HIST_AGES;  i++)
+    {
+        s_size(c->c_ages[i], c_ent);
+        s_size(c->c_agebytes[i], c_byte);
+        out_printf(" %-10s %12s %18s %5.1f\n",
+            hist_ages[i].a_name, c_ent, c_byte, 100.0 * c->c_ages[i] / tot);
+    }
+}
+
+
+/*------------------------------------------------------------------------------
+* count_entry()
+*	Adds file info 'info', of size 'sz', with path prefix parts 'drive',
+*	'pre', and 'sep', to the count totals.
+*/
+
+static void count_entry(const char *drive, const char *pre, const char *sep, struct _WIN32_FIND_DATAA *info, uint64_t sz)
+{
+    /* Update the counters */
+    if (info->dwFileAttributes & A_DIRECTORY)
+        count.c_dir++;
+    else if (not (info->dwFileAttributes & A_VOLUME))
+        count.c_file++;
+
+    if (info->dwFileAttributes & (A_SYSTEM|A_HIDDEN))
+        count.c_hidden++;
+
+    count.c_bytes  += sz;
+    count.c_blocks += (sz + BLOCKSIZE-1)/BLOCKSIZE;
+
+    if (opt.o_hist)
+        hist_add(sz, &info->ftLastWriteTime);
+
+    if (opt.o_groupkey != GROUP_NONE)
+        group_entry(walk != NULL ? &walk->w_group : &groups,
+            drive, pre, sep, info, sz);
+}
+
+
+/*------------------------------------------------------------------------------
+* print_entry()
+*	Prints info about file info 'info' with drive prefix 'drive' and path
+*	prefix 'pre' to the output.
+*/
+
+static void print_entry(const char *drive, const char *pre, struct _WIN32_FIND_DATAA *info)
+{
+    const char *	sep = SEP_STR;
+    uint64_t		sz;
+
+    DL(printf("|drive='%.80s' pre1='%.999s'\n", drive, pre));
+
+    sz = ((uint64_t)info->nFileSizeHigh << 32) + info->nFileSizeLow;
+    if (opt.o_nolist)
+    {
+        /* Only the totals are printed, so skip formatting the entry */
+        count_entry(drive, pre, sep, info, sz);
+        return;
+    }
+
+    /* Get the path prefix and separator */
+    for (;;)
+    {
+        if (pre[0] == '.'  and  pre[1] == '\0')
+        {
+            pre = "";
+            sep = "";
+            break;
+        }
+        else if (pre[0] == '.'  and  pre[1] == SEP_CHAR)
+        {
+            /* Remove './' prefixes */
+            while (pre[0] == '.'  and  pre[1] == SEP_CHAR)
+                pre += 2;
+        }
+        else
+            break;
+    }
+
+    DL(printf("|drive='%.80s' pre2='%.999s'\n", drive, pre));
+
+    /* Print the info for a directory entry */
+    if (opt.o_topn > 0)
+        top_entry(walk != NULL ? &walk->w_top : &top,
+            drive, pre, sep, info, sz);
+    else if (opt.o_sort != SORT_NONE)
+        sort_add(walk != NULL ? &walk->w_sort : &sorter,
+            drive, pre, sep, info, sz);
+    else
+        print_fmt(drive, pre, sep, info, sz);
+
+    count_entry(drive, pre, sep, info, sz);
+}
+
+
+/*------------------------------------------------------------------------------
+* add_count()
+*	Adds count totals 'from' to count totals 'to'.
+*/
+
+static void add_count(struct Count *to, const struct Count *from)
+{
+    int		i;
+
+    to->c_dir +=    from->c_dir;
+    to->c_file +=   from->c_file;
+    to->c_hidden += from->c_hidden;
+    to->c_bytes +=  from->c_bytes;
+    to->c_blocks += from->c_blocks;
+
+    if (opt.o_hist)
+    {
+        for (i = 0;  i < HIST_SIZES;  i++)
+        {
+            to->c_sizes[i] +=     from->c_sizes[i];
+            to->c_sizebytes[i] += from->c_sizebytes[i];
+        }
+        for (i = 0;  i < HIST_AGES;  i++)
+        {
+            to->c_ages[i] +=     from->c_ages[i];
+            to->c_agebytes[i] += from->c_agebytes[i];
+        }
+    }
+}
+
+
+/*------------------------------------------------------------------------------
+* du_line()
+*	Prints the usage totals 'c' of directory 'drive' and 'path'.
+*/
+
+static void du_line(const char *drive, const char *path, const struct Count *c)
+{
+    char	c_byte[30+1];
+    char	c_block[30+1];
+    char	c_ent[30+1];
+
+    s_size(c->c_bytes, c_byte);
+    s_size(c->c_blocks, c_block);
+    s_size(c->c_dir + c->c_file, c_ent);
+
+    /* Remove './' prefixes */
+    while (path[0] == '.'  and  path[1] == SEP_CHAR)
+        path += 2;
+
+    out_printf("%15s %12s %12s  ", c_byte, c_block, c_ent);
+    out_puts(drive);
+    out_puts(path);
+    out_putc('\n');
+}
+
+
+/*------------------------------------------------------------------------------
+* du_begin()
+*	Saves the count totals before a directory is searched into 'base'.
+*/
+
+static void du_begin(struct Count *base)
+{
+    *base = count;
+}
+
+
+/*------------------------------------------------------------------------------
+* du_end()
+*	Prints the usage totals of directory 'drive' and 'pre', which are the
+*	count totals added since 'base' was saved by du_begin().
+*	The directory is not printed if it is deeper than the '-du' depth limit.
+*
+*	A parallel search thread does not search the subdirectories itself, so
+*	it saves the totals in the directory being searched instead, and
+*	print_dir() adds up the subdirectory totals and prints them.
+*/
+
+static void du_end(const struct Count *base, const char *drive, const char *pre)
+{
+    struct Count	c;
+
+    /* Only the totals are kept, not the histograms ('-hist') */
+    memset(&c, '\0', sizeof(c));
+    c.c_dir =    count.c_dir -    base->c_dir;
+    c.c_file =   count.c_file -   base->c_file;
+    c.c_hidden = count.c_hidden - base->c_hidden;
+    c.c_bytes =  count.c_bytes -  base->c_bytes;
+    c.c_blocks = count.c_blocks - base->c_blocks;
+
+    if (walk != NULL)
+    {
+        struct Dir *	d = walk->w_dir;
+
+        d->d_count = c;
+        d->d_path = (char *) malloc(strlen(drive) + strlen(pre) + 1);
+        if (d->d_path == NULL)
+        {
+            fprintf(stderr, "%s: Out of memory\n", prog);
+            exit(RC_ERR);
+        }
+        strcpy(d->d_path, drive);
+        strcat(d->d_path, pre);
+    }
+    else if (dir_depth <= opt.o_dudepth)
+        du_line(drive, pre, &c);
+}
+
+
+/*------------------------------------------------------------------------------
+* new_dir()
+*	Allocates a parallel search directory for search pattern 'pat'.
+*/
+
+static struct Dir * new_dir(const char *pat)
+{
+    struct Dir *	d;
+
+    d = (struct Dir *) calloc(1, sizeof(struct Dir));
+    if (d == NULL  or  (d->d_pat = strdup(pat)) == NULL)
+    {
+        fprintf(stderr, "%s: Out of memory\n", prog);
+        exit(RC_ERR);
+    }
+    return d;
+}
+
+
+/*------------------------------------------------------------------------------
+* free_dir()
+*	Deallocates parallel search directory 'd'.
+*/
+
+static void free_dir(struct Dir *d)
+{
+    free(d->d_path);
+    free(d->d_out);
+    free(d->d_pat);
+    free(d);
+}
+
+
+/*------------------------------------------------------------------------------
+* add_subdir()
+*	Adds a subdirectory with search pattern 'pat' to the end of the
+*	subdirectories of parallel search directory 'dir'.
+*	The subdirectories are queued to be searched once the search of 'dir'
+*	is complete.
+*/
+
+static void add_subdir(struct Dir *dir, const char *pat)
+{
+    struct Dir *	d;
+
+    d = new_dir(pat);
+    d->d_depth = dir->d_depth + 1;
+    d->d_ignore = ignores;
+    if (dir->d_last == NULL)
+        dir->d_child = d;
+    else
+        dir->d_last->d_next = d;
+    dir->d_last = d;
+}
+
+
+/*------------------------------------------------------------------------------
+* limit_match()
+*	Counts a matching entry against the '-max' limit.  Once the limit is
+*	reached, the search is stopped.
+*
+* Returns
+*	True if the entry is within the limit, otherwise false.
+*/
+
+static bool limit_match(void)
+{
+    LONG	n;
+
+    n = InterlockedIncrement(&found);
+    if (n >= opt.o_max)
+        stop_search();
+    return (n <= opt.o_max);
+}
+
+
+/*------------------------------------------------------------------------------
+* search_dir()
+*	Searches for filenames that match pattern 'pat'.
+*	All found entries are printed to the output.
+*
+*	If 'dir' is not null, the search is being done by a parallel search
+*	thread, and the subdirectories found are added to 'dir' instead of
+*	being searched recursively.  If 'flat' is true, the subdirectories are
+*	not searched at all.
+*
+* Returns
+*	Number of matching filenames found.
+*/
+
+static uint64_t search_dir(const char *pat, struct Dir *dir, bool flat)
+{
+    const char *	ip;
+    char *		jp;
+    const char *	pre2;			/* Printable path prefix	*/
+    uint64_t		count = 0;		/* Matching filename count	*/
+    const char *	file;			/* Filename w/ wildcards	*/
+    size_t		prefixlen;		/* Path prefix size		*/
+    size_t		patlen;			/* File pattern size		*/
+    struct Count	base;			/* Count totals before search	*/
+    const struct Ignores *	up;		/* Ignore rules of parent dirs	*/
+    struct search_info	info;			/* Search control info		*/
+    char		drive[2+1];		/* Search drive prefix		*/
+    char		pre[12*1024+1];		/* Search path prefix		*/
+    char		pathname[16*1024+1];	/* Working pathname pattern	*/
+
+    /* Separate the drive prefix from the pattern */
+    if (pat[0] != '\0'  and  pat[1] == ':')
+    {
+        drive[0] = pat[0];
+        drive[1] = ':';
+        drive[2] = '\0';
+        pat += 2;
+    }
+    else
+        drive[0] = '\0';
+
+    /* Separate the directory prefix from the pattern */
+    ip = strrchr(pat, '/');
+    jp = strrchr(pat, '\\');
+    ip = (ip > jp ? ip : jp);
+
+    if (ip == NULL)
+    {
+        /* No '/' or '\' in pat */
+        file = pat;
+        strcpy(pre, ".");
+        pre2 = pre;
+    }
+    else
+    {
+        /* Separate the path prefix and filename in the pattern */
+        file = ip+1;
+        if (ip-pat > 0)
+        {
+            if (ip-pat >= sizeof(pre))
+            {
+                fprintf(stderr, "error: Filename directory prefix is too long\n");
+                exit(RC_ERR);
+            }
+            memcpy(pre, pat, ip-pat);
+            pre[ip-pat] = '\0';
+            pre2 = pre;
+        }
+        else
+        {
+            strcpy(pre, SEP_STR);
+            pre2 = "";
+        }
+
+        for (jp = pre;  *jp != '\0';  jp++)
+            if (*jp == '\\'  or  *jp == '/')
+                *jp = SEP_CHAR;
+    }
+
+    prefixlen = strlen(drive) + strlen(pre) + 1;
+    patlen = strlen(file);
+
+    DL(printf("|drv=[%.80s] pre=[%.999s] pre2=[%.999s] file=[%.999s]\n",
+        drive, pre, pre2, file));
+
+    /* Verify the file pattern */
+    if (not fpattern_isvalid(file))
+    {
+        fprintf(stderr, "%s: Ill-formed filename pattern '%s'\n", prog, file);
+        return 0;
+    }
+
+    /* Skip a directory already searched (through a directory link, or by
+    another expansion of a pattern with several "**" components) */
+    if (opt.o_follow  or  visit_once)
+    {
+        strcpy(pathname, drive);
+        strcat(pathname, pre);
+        if (not visit_dir(pathname, VISIT_DIR))
+            return 0;
+    }
+
+    if (opt.o_du)
+        du_begin(&base);
+
+    /* Read the ignore files of this directory */
+    up = ignores;
+    if (opt.o_ignore)
+        ignores = ign_enter(drive, pre);
+
+    /* Build the working search pattern */
+    if (prefixlen + strlen(WILD_WIN32) + patlen >= sizeof(pathname))
+    {
+        fprintf(stderr, "error: Filename pattern is too long\n");
+        exit(RC_ERR);
+    }
+    strcpy(pathname, drive);
+    strcat(pathname, pre);
+    if (pre[0] != SEP_CHAR  or  pre[1] != '\0')
+        strcat(pathname, SEP_STR);
+#if OLD /* pre-3.61 */
+    strcat(pathname, file);
+#else
+    if (lookup_name  and  not (lookup_dirs  and  case_dir(pathname)))
+        strcat(pathname, file);
+    else
+        strcat(pathname, WILD_WIN32);
+#endif
+
+    DL(printf("|search=[%.999s]\n", pathname));
+
+    /* Search for the first matching entry */
+    memset(&info, '\0', sizeof(info));
+    if (opt.o_verbose)
+        out_printf("Searching \"%.80s%.999s\"\n", drive, pre);
+
+    if (dir_depth < opt.o_mindepth)
+    {
+        /* Above the '-mindepth' limit, only search the subdirs */
+        DL(printf("|%.999s: <above mindepth>\n", pathname));
+    }
+    else if (not findfirst32(pathname, AX_DFL, &info))
+    {
+        /* First match not found */
+        DL(printf("|%.999s: <none>\n", pathname));
+    }
+    else
+    {
+        /* Print matches */
+        DL(printf("|%.999s: first: [%.999s]\n", pathname, info.fdata.cFileName));
+        do
+        {
+            bool	incl = false;
+
+            /* Found next entry, attempt to match it */
+            if (file[0] == '*'  and  include_entry(&info.fdata)  and  fpattern_matchn(file, info.fdata.cFileName))
+                incl = true;
+            else
+                incl = (fpattern_matchn(file, info.fdata.cFileName)  and  include_entry(&info.fdata));
+
+            if (incl  and  ignores != NULL  and  ign_match(drive, pre, &info.fdata))
+                incl = false;
+
+            if (incl)
+            {
+                /* Found a matching entry, print it */
+                if (opt.o_max > 0  and  not limit_match())
+                    break;
+                count++;
+                print_entry(drive, pre2, &info.fdata);
+            }
+        } while (not stopped  and  findnext32(&info));
+        findclose32(&info);
+    }
+
+    /* Print the matching entries of this directory in sorted order */
+    if (opt.o_sort == SORT_DIR)
+        sort_dir(walk != NULL ? &walk->w_sort : &sorter);
+
+    /* Search for subdirs */
+    DL(printf("-------------------------------------\n"));
+    if (not opt.o_nosubdirs  and  not flat  and  not stopped
+        and  (opt.o_maxdepth < 0  or  dir_depth < opt.o_maxdepth))
+    {
+        /* Build the working search pattern */
+        strcpy(pathname, drive);
+        strcat(pathname, pre);
+        if (pre[0] != SEP_CHAR  or  pre[1] != '\0')
+            strcat(pathname, SEP_STR);
+        strcat(pathname, WILD_WIN32);
+
+        DL(printf("|subsearch=[%.999s]\n", pathname));
+
+        /* Search for the first subdir entry */
+        if (findfirst32(pathname, A_DIRECTORY, &info))
+        {
+            /* Recursively search any subdirs */
+            DL(printf("|%.999s: first sub: [%.999s]\n", pathname, info.fdata.cFileName));
+            do
+            {
+                /* Next subdir found, search in it */
+                if (enter_dir(&info.fdata)  and
+                    not (ignores != NULL  and  ign_match(drive, pre, &info.fdata))  and
+                    not (opt.o_prunematch  and  dir_depth >= opt.o_mindepth  and
+                        fpattern_matchn(file, info.fdata.cFileName)  and
+                        include_entry(&info.fdata)))
+                {
+                    /* Build the next working search pattern */
+                    if (prefixlen + strlen(info.fdata.cFileName) + 1 + patlen >= sizeof(pathname))
+                    {
+                        fprintf(stderr, "error: Filename pattern is too long\n");
+                        continue;
+                    }
+                    strcpy(pathname, drive);
+                    strcat(pathname, pre);
+                    if (pre[0] != SEP_CHAR  or  pre[1] != '\0')
+                        strcat(pathname, SEP_STR);
+                    strcat(pathname, info.fdata.cFileName);
+                    strcat(pathname, SEP_STR);
+                    strcat(pathname, file);
+
+                    /* Recursively search the next subdir */
+                    DL(printf("|recurse=[%.999s]\n", pathname));
+                    if (dir != NULL)
+                        add_subdir(dir, pathname);
+                    else
+                    {
+                        dir_depth++;
+                        count += search_dir(pathname, NULL, false);
+                        dir_depth--;
+                    }
+                }
+            } while (not stopped  and  findnext32(&info));
+            findclose32(&info);
+        }
+    }
+    else if (not stopped)
+    {
+        DL(printf("Do not recurse on subdirs\n"));
+    }
+
+    /* Print the usage totals for this directory */
+    if (opt.o_du)
+        du_end(&base, drive, pre);
+
+    ignores = up;
+    return count;
+}
+
+
+/*------------------------------------------------------------------------------
+* work_push()
+*	Queues parallel search directory 'first', and its following siblings,
+*	to be searched.  The directories are pushed so that 'first' is on top.
+*/
+
+static void work_push(struct Dir *first)
+{
+    struct Dir *	d;
+    LONG		n = 0;
+
+    EnterCriticalSection(&work.q_lock);
+    for (d = first;  d != NULL;  d = d->d_next)
+    {
+        d->d_qnext = (d->d_next != NULL ? d->d_next : work.q_top);
+        n++;
+    }
+    work.q_top = first;
+    InterlockedExchangeAdd(&work.q_pending, n);
+    LeaveCriticalSection(&work.q_lock);
+
+    ReleaseSemaphore(work.q_avail, n, NULL);
+}
+
+
+/*------------------------------------------------------------------------------
+* work_get()
+*	Waits for the next queued directory to be searched.
+*
+* Returns
+*	The directory to search, or null if the search is complete or has
+*	been stopped.
+*/
+
+static struct Dir * work_get(void)
+{
+    struct Dir *	d;
+
+    WaitForSingleObject(work.q_avail, INFINITE);
+    if (stopped)
+        return NULL;
+
+    EnterCriticalSection(&work.q_lock);
+    d = work.q_top;
+    if (d != NULL)
+        work.q_top = d->d_qnext;
+    LeaveCriticalSection(&work.q_lock);
+
+    return d;
+}
+
+
+/*------------------------------------------------------------------------------
+* work_done()
+*	Marks parallel search directory 'd' as searched, and queues its
+*	subdirectories to be searched.  If this was the last directory to be
+*	searched, all of the search threads are woken up to quit.
+*/
+
+static void work_done(struct Dir *d)
+{
+    if (d->d_child != NULL)
+        work_push(d->d_child);
+
+    if (opt.o_unordered)
+    {
+        /* The output has already been printed */
+        free_dir(d);
+    }
+    else
+    {
+        /* Let the main thread print the output */
+        InterlockedExchange(&d->d_done, 1);
+        SetEvent(work.q_progress);
+    }
+
+    if (InterlockedDecrement(&work.q_pending) == 0)
+        ReleaseSemaphore(work.q_avail, MAX_JOBS, NULL);
+}
+
+
+/*------------------------------------------------------------------------------
+* search_worker()
+*	Parallel search thread.
+*	Searches queued directories until the search is complete, then adds its
+*	counts to the totals.
+*/
+
+static DWORD WINAPI search_worker(LPVOID arg)
+{
+    struct Walk *	w;
+    struct Dir *	d;
+
+    (void) arg;
+
+    w = (struct Walk *) calloc(1, sizeof(struct Walk));
+    if (w == NULL)
+    {
+        fprintf(stderr, "%s: Out of memory\n", prog);
+        exit(RC_ERR);
+    }
+    walk = w;
+
+    /* Search queued directories */
+    while ((d = work_get()) != NULL)
+    {
+        w->w_dir = d;
+        dir_depth = d->d_depth;
+        ignores = d->d_ignore;
+        last_prefix[0] = DIRS_CHAR;
+        last_prefix[1] = '\0';
+
+        w->w_matches += search_dir(d->d_pat, d, work.q_flat);
+        walk_publish(w);
+        work_done(d);
+    }
+
+    /* Add this thread's counts to the totals */
+    EnterCriticalSection(&work.q_lock);
+    work.q_matches += w->w_matches;
+    add_count(&work.q_count, &count);
+    if (opt.o_groupkey != GROUP_NONE)
+        group_join(&groups, &w->w_group);
+    if (opt.o_topn > 0)
+        top_join(&top, &w->w_top);
+    else if (opt.o_sort != SORT_NONE)
+        sort_join(&sorter, &w->w_sort);
+    LeaveCriticalSection(&work.q_lock);
+
+    walk = NULL;
+    free(w);
+    free(json_key);
+    free(json_pre);
+
+    /* Let the main thread know if the search was stopped */
+    InterlockedDecrement(&work.q_active);
+    SetEvent(work.q_progress);
+    return 0;
+}
+
+
+/*------------------------------------------------------------------------------
+* print_dir()
+*	Prints the saved output of parallel search directory 'd' and all of its
+*	subdirectories, in depth-first order, waiting for each one to be
+*	searched.  The directories are deallocated as they are printed.
+*
+*	With '-du', the usage totals of each directory are printed after those
+*	of its subdirectories, and are added to the totals 'up' of its parent
+*	directory (if not null).
+*
+*	If the search was stopped early, directories that will never be
+*	searched are deallocated without printing anything.
+*/
+
+static void print_dir(struct Dir *d, struct Count *up)
+{
+    struct Dir *	c;
+    struct Dir *	next;
+
+    while (d->d_done == 0)
+    {
+        if (stopped  and  work.q_active == 0)
+            break;
+        WaitForSingleObject(work.q_progress, INFINITE);
+    }
+
+    if (d->d_done == 0)
+    {
+        free_dir(d);
+        return;
+    }
+
+    ring_put(d->d_out, d->d_outlen);
+
+    for (c = d->d_child;  c != NULL;  c = next)
+    {
+        next = c->d_next;
+        print_dir(c, &d->d_count);
+    }
+
+    if (opt.o_du)
+    {
+        /* A directory skipped by its search has no totals line */
+        if (d->d_path != NULL  and  d->d_depth <= opt.o_dudepth)
+            du_line("", d->d_path, &d->d_count);
+        if (up != NULL)
+            add_count(up, &d->d_count);
+    }
+
+    free_dir(d);
+}
+
+
+/*------------------------------------------------------------------------------
+* search_parallel()
+*	Searches for filenames that match pattern 'pat', using 'opt.o_jobs'
+*	search threads.  All found entries are printed to the output, in the
+*	same order as a single-threaded search unless '-U' was specified.
+*
+* Returns
+*	Number of matching filenames found.
+*/
+
+static uint64_t search_parallel(const char *pat, bool flat)
+{
+    HANDLE		threads[MAX_JOBS];
+    HANDLE		h;
+    struct Dir *	root;
+    const char *	file;
+    int			i, n;
+
+    /* Verify the file pattern before starting any search threads */
+    file = pat + strlen(pat);
+    while (file > pat  and  file[-1] != '/'  and  file[-1] != '\\'  and  file[-1] != ':')
+        file--;
+    if (not fpattern_isvalid(file))
+    {
+        fprintf(stderr, "%s: Ill-formed filename pattern '%s'\n", prog, file);
+        return 0;
+    }
+
+    /* Initialize the work queue */
+    InitializeCriticalSection(&work.q_lock);
+    InitializeCriticalSection(&work.q_outlock);
+    work.q_avail = CreateSemaphore(NULL, 0, 0x7FFFFFFF, NULL);
+    work.q_progress = CreateEvent(NULL, FALSE, FALSE, NULL);
+    work.q_top = NULL;
+    work.q_pending = 0;
+    work.q_active = opt.o_jobs;
+    work.q_matches = 0;
+    work.q_flat = flat;
+    memset(&work.q_count, 0, sizeof(work.q_count));
+
+    root = new_dir(pat);
+    root->d_ignore = ignores;
+    work_push(root);
+
+    /* Start the search threads */
+    for (n = 0;  n < opt.o_jobs;  n++)
+    {
+        threads[n] = CreateThread(NULL, 0, search_worker, NULL, 0, NULL);
+        if (threads[n] == NULL)
+            break;
+    }
+    DL(printf("|search_parallel: %d threads\n", n));
+
+    if (n == 0)
+    {
+        fprintf(stderr, "%s: Cannot start search threads\n", prog);
+        exit(RC_ERR);
+    }
+    InterlockedExchangeAdd(&work.q_active, n - opt.o_jobs);
+
+    /* Print the saved output in order */
+    if (not opt.o_unordered)
+        print_dir(root, NULL);
+
+    /* Wait for the search threads to finish */
+    for (i = 0;  i < n;  i++)
+    {
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+    }
+
+    /* Discard the directories left unsearched by a stopped search */
+    if (opt.o_unordered)
+    {
+        struct Dir *	d;
+
+        while ((d = work.q_top) != NULL)
+        {
+            work.q_top = d->d_qnext;
+            free_dir(d);
+        }
+    }
+
+    h = work.q_avail;
+    work.q_avail = NULL;
+    CloseHandle(h);
+    CloseHandle(work.q_progress);
+    DeleteCriticalSection(&work.q_lock);
+    DeleteCriticalSection(&work.q_outlock);
+
+    add_count(&count, &work.q_count);
+    return work.q_matches;
+}
+
+
+/*------------------------------------------------------------------------------
+* est_random()
+*	Returns a pseudo-random number in the range [0, n).
+*	This is a xorshift64* generator.
+*/
+
+static unsigned int est_random(unsigned int n)
+{
+    est_seed ^= est_seed >> 12;
+    est_seed ^= est_seed << 25;
+    est_seed ^= est_seed >> 27;
+    return (unsigned int) (((est_seed * 2685821657736338717ULL) >> 32) % n);
+}
+
+
+/*------------------------------------------------------------------------------
+* estimate()
+*	Estimates the number and total size of the filenames that match
+*	pattern 'pat', and the number of directories searched, by reading at
+*	most about 'opt.o_estreads' directories.  The estimates are printed to
+*	the output.
+*
+*	This is Knuth's tree size estimation: each probe walks down the tree
+*	from the top directory, choosing one of the subdirectories of each
+*	directory at random, until it reaches a directory without any.  An
+*	entry found by the probe in a directory that was reached by choosing
+*	among k1, k2, ... subdirectories stands for k1*k2*... entries, which
+*	makes each probe an unbiased estimate of the totals.  The probes are
+*	repeated until the directory read limit is reached, and the mean of
+*	the probes is printed with its 95% confidence interval.
+*
+* Returns
+*	Estimated number of matching filenames.
+*/
+
+static uint64_t estimate(const char *pat, bool flat)
+{
+    const char *	ip;
+    const char *	jp;
+    const char *	file;
+    long		probes = 0;
+    long		reads = 0;
+    int			i;
+    double		mean[3] = { 0, 0, 0 };	/* Matches, bytes, dirs	*/
+    double		m2[3] =   { 0, 0, 0 };
+    struct search_info	info;
+    size_t		dirlen;
+    const struct Ignores *	up = ignores;	/* Ignore rules of parent dirs */
+    char		path[16*1024+1];
+    char		dir[16*1024+1];
+    char		pick[MAX_PATH+1];
+    char		c_est[30+1];
+    char		c_lo[30+1];
+    char		c_hi[30+1];
+    static const char *	names[3] =
+        { " Entries:     ", " Bytes:       ", " Directories: " };
+
+    /* Separate the directory prefix from the pattern */
+    ip = strrchr(pat, '/');
+    jp = strrchr(pat, '\\');
+    ip = (ip > jp ? ip : jp);
+    file = (ip != NULL ? ip+1 : pat);
+    dirlen = (ip != NULL ? ip-pat : 0);
+    if (ip == NULL  and  pat[0] != '\0'  and  pat[1] == ':')
+    {
+        /* Drive prefix only */
+        file = pat+2;
+        dirlen = 2;
+    }
+    if (dirlen + 1 + MAX_PATH >= sizeof(path))
+    {
+        fprintf(stderr, "error: Filename directory prefix is too long\n");
+        exit(RC_ERR);
+    }
+
+    if (not fpattern_isvalid(file))
+    {
+        fprintf(stderr, "%s: Ill-formed filename pattern '%s'\n", prog, file);
+        return 0;
+    }
+
+    /* Probe the directory tree */
+    while (reads < opt.o_estreads)
+    {
+        double		x[3] = { 0, 0, 0 };
+        double		w = 1;
+        size_t		len;
+        int		depth = 0;
+
+        memcpy(path, pat, dirlen);
+        path[dirlen] = '\0';
+        if (ip == pat)
+            strcpy(path, SEP_STR);
+        ignores = up;
+
+        for (;;)
+        {
+            unsigned int	k = 0;
+
+            /* Read the ignore files of the directory */
+            if (opt.o_ignore)
+            {
+                strcpy(dir, path);
+                ignores = ign_enter("", dir);
+            }
+
+            /* Read the directory */
+            len = strlen(path);
+            if (len > 0  and  strchr(SEP_STR "/:", path[len-1]) == NULL)
+                strcat(path, SEP_STR);
+            strcat(path, WILD_WIN32);
+            reads++;
+
+            if (findfirst32(path, AX_DFL, &info))
+            {
+                do
+                {
+                    struct _WIN32_FIND_DATAA *	fd = &info.fdata;
+
+                    /* Count a matching entry */
+                    if (depth >= opt.o_mindepth
+                        and  fpattern_matchn(file, fd->cFileName)
+                        and  include_entry(fd)
+                        and  not (ignores != NULL  and  ign_match("", dir, fd)))
+                    {
+                        x[0] += w;
+                        x[1] += w * (((uint64_t)fd->nFileSizeHigh << 32)
+                            + fd->nFileSizeLow);
+                    }
+
+                    /* Choose one of the subdirectories at random */
+                    if (not opt.o_nosubdirs  and  not flat  and  enter_dir(fd)
+                        and  not (ignores != NULL  and  ign_match("", dir, fd))
+                        and  (opt.o_maxdepth < 0  or  depth < opt.o_maxdepth)
+                        and  not (opt.o_prunematch  and  depth >= opt.o_mindepth
+                            and  fpattern_matchn(file, fd->cFileName)
+                            and  include_entry(fd)))
+                    {
+                        if (est_random(++k) == 0)
+                            strcpy(pick, fd->cFileName);
+                    }
+                } while (findnext32(&info));
+            }
+            x[2] += w;
+
+            /* Descend into the chosen subdirectory */
+            path[len] = '\0';
+            if (k == 0
+                or  len + 1 + strlen(pick) >= sizeof(path) - 1 - MAX_PATH)
+                break;
+            w *= k;
+            depth++;
+            if (len > 0  and  strchr(SEP_STR "/:", path[len-1]) == NULL)
+                strcat(path, SEP_STR);
+            strcat(path, pick);
+        }
+
+        /* Add the probe to the running means and variances (Welford) */
+        probes++;
+        for (i = 0;  i < 3;  i++)
+        {
+            double	d = x[i] - mean[i];
+
+            mean[i] += d / probes;
+            m2[i] += d * (x[i] - mean[i]);
+        }
+
+        /* A probe that made no random choices is exact */
+        if (w == 1)
+            break;
+    }
+
+    /* Print the estimates */
+    out_printf(" Estimated from %ld probes (%ld directory reads):\n",
+        probes, reads);
+    for (i = 0;  i < 3;  i++)
+    {
+        double	ci = 0;
+        double	lo;
+
+        /* 95% confidence interval of the mean */
+        if (probes > 1)
+            ci = 1.96 * sqrt(m2[i] / (probes-1) / probes);
+        lo = (mean[i] > ci ? mean[i] - ci : 0);
+
+        s_size((uint64_t) (mean[i] + 0.5), c_est);
+        s_size((uint64_t) (lo + 0.5), c_lo);
+        s_size((uint64_t) (mean[i] + ci + 0.5), c_hi);
+        out_printf("%s%15s  (%s to %s)\n", names[i], c_est, c_lo, c_hi);
+    }
+
+    ignores = up;
+    return (uint64_t) (mean[0] + 0.5);
+}
+
+
+/*------------------------------------------------------------------------------
+* search_tree()
+*	Searches the directory tree named by the directory prefix of pattern
+*	'pat' for filenames that match its filename part.  If 'flat' is true,
+*	only the directory itself is searched, without its subdirectories.
+*
+* Returns
+*	Number of matching filenames found.
+*/
+
+static uint64_t search_tree(const char *pat, bool flat)
+{
+    if (opt.o_estreads > 0)
+        return estimate(pat, flat);
+    if (opt.o_jobs > 1)
+        return search_parallel(pat, flat);
+    return search_dir(pat, NULL, flat);
+}
+
+
+/*------------------------------------------------------------------------------
+* wild_comp()
+*	Determine if the 'n' characters of pattern component 's' contain any
+*	of the wildcard characters 'wild', or '{a,b}' alternatives.
+*
+* Returns
+*	True if the component contains wildcards, otherwise false.
+*/
+
+static bool wild_comp(const char *s, size_t n, const char *wild)
+{
+    const char *	brace = NULL;
+    const char *	comma = NULL;
+
+    for ( ;  n > 0;  s++, n--)
+    {
+        if (strchr(wild, *s) != NULL)
+            return true;
+
+        /* Braces are alternatives only if they enclose a ',' */
+        if (*s == '{'  and  brace == NULL)
+            brace = s;
+        else if (*s == ','  and  brace != NULL)
+            comma = s;
+        else if (*s == '}'  and  comma != NULL)
+            return true;
+    }
+    return false;
+}
+
+
+/*------------------------------------------------------------------------------
+* wild_dir()
+*	Determine if the 'n' characters of directory component 's' are to be
+*	matched as a pattern.  The component must contain a '*' or '?', a
+*	'[...]' set, or '{a,b}' alternatives, and be a well-formed pattern.
+*	Other components (e.g., "Hello!" or "[old") are taken literally.
+*
+* Returns
+*	True if the component is a pattern, otherwise false.
+*/
+
+static bool wild_dir(const char *s, size_t n)
+{
+    char	comp[MAX_PATH+1];
+
+    if (n > MAX_PATH  or  not wild_comp(s, n, WILD_DIR))
+        return false;
+
+    memcpy(comp, s, n);
+    comp[n] = '\0';
+    return (fpattern_isvalid(comp) != 0);
+}
+
+
+/*------------------------------------------------------------------------------
+* ign_path()
+*	Copies the first 'len' characters of directory path 'path' (as built by
+*	search_path(), ending with a separator) into 'dir', in the form of the
+*	directory prefix used by search_dir() for ign_enter() and ign_match().
+*/
+
+static void ign_path(char *dir, const char *path, size_t len)
+{
+    char *	p;
+
+    memcpy(dir, path, len);
+    dir[len] = '\0';
+    for (p = dir;  *p != '\0';  p++)
+        if (*p == '/')
+            *p = SEP_CHAR;
+
+    /* Drop the trailing separator, except from a root directory */
+    while (len > 1  and  dir[len-1] == SEP_CHAR
+        and  dir[len-2] != SEP_CHAR  and  dir[len-2] != ':')
+        dir[--len] = '\0';
+}
+
+
+/*------------------------------------------------------------------------------
+* is_dir()
+*	Determine if 'path' names an existing directory.
+*
+* Returns
+*	True if 'path' is a directory, otherwise false.
+*/
+
+static bool is_dir(const char *path)
+{
+    DWORD	attr;
+
+    attr = GetFileAttributesA(path);
+    return (attr != INVALID_FILE_ATTRIBUTES  and  (attr & A_DIRECTORY) != 0);
+}
+
+
+/*------------------------------------------------------------------------------
+* search_path()
+*	Searches for filenames that match pattern 'rest', whose directory
+*	prefix contains wildcard components (e.g., "src\*\test\*.c"),
+*	relative to directory 'path' (which is empty or ends with a separator).
+*
+*	The literal components preceding the first wildcard component are
+*	checked with a single lookup, without reading any directories.  The
+*	subdirectories matching the wildcard component are found, and the rest
+*	of the pattern is searched for within each of them, one component at a
+*	time, so that directories that cannot match are never read.  Once no
+*	wildcard components remain, the matching directory is searched for the
+*	filename part of the pattern as usual.
+*
+*	A "**" component matches zero or more subdirectories, so the rest of
+*	the pattern is searched for within the directory itself and within
+*	each of its subdirectories in turn.  After a "**" component ('flat' is
+*	true), the matching directories are searched without their
+*	subdirectories, since those are already reached by the "**".  A "**"
+*	followed only by the filename is a search of the whole tree below the
+*	directory, so it is done as usual (e.g., with '-j' or '-est').
+*
+*	With '-ignore', the ignore rules of each directory are applied to the
+*	subdirectories matching a component, and to the literal components
+*	following a matching component, as search_dir() applies them.
+*
+* Returns
+*	Number of matching filenames found.
+*/
+
+static uint64_t search_path(char *path, const char *rest, bool flat)
+{
+    const struct Ignores *	up = ignores;	/* Ignore rules of parent dirs */
+    const char *	cp;			/* Wildcard component	*/
+    const char *	ep;			/* End of the component	*/
+    const char *	next;			/* Rest of the pattern	*/
+    size_t		base;			/* Directory path size	*/
+    size_t		len;			/* With literal components */
+    uint64_t		count = 0;		/* Matching filename count */
+    bool		globstar;		/* Component is "**"	*/
+    struct search_info	info;			/* Search control info	*/
+    char		comp[MAX_PATH+1];	/* Component pattern	*/
+    char		dir[16*1024+1];		/* Directory (-ignore)	*/
+
+    /* Find the first wildcard directory component, or the filename */
+    for (cp = rest;  ;  cp = ep+1)
+    {
+        ep = cp + strcspn(cp, "/\\");
+        if (*ep == '\0'  or  wild_dir(cp, ep-cp))
+            break;
+    }
+
+    base = strlen(path);
+    len = base + (cp-rest);
+    if (ep-cp > MAX_PATH  or  len + strlen(cp) + strlen(WILD_WIN32) >= 16*1024)
+    {
+        fprintf(stderr, "error: Filename pattern is too long\n");
+        return 0;
+    }
+
+    /* Look up the literal components preceding it directly */
+    memcpy(path+base, rest, cp-rest);
+    path[len] = '\0';
+    if (cp > rest  and  not is_dir(path))
+    {
+        DL(printf("|search_path: [%.999s] <none>\n", path));
+        path[base] = '\0';
+        return 0;
+    }
+
+    if (opt.o_ignore)
+    {
+        const char *	lp;
+        const char *	lep;
+
+        /* Skip the directory if one of the literal components is ignored */
+        memset(&info, '\0', sizeof(info));
+        info.fdata.dwFileAttributes = A_DIRECTORY;
+        for (lp = rest;  lp < cp;  lp = lep+1)
+        {
+            lep = lp + strcspn(lp, "/\\");
+            if (lep == lp  or  lep-lp >= sizeof(info.fdata.cFileName))
+                continue;
+            memcpy(info.fdata.cFileName, lp, lep-lp);
+            info.fdata.cFileName[lep-lp] = '\0';
+
+            ign_path(dir, path, base + (lp-rest));
+            ignores = ign_enter("", dir);
+            if (ignores != NULL  and  ign_match("", dir, &info.fdata))
+            {
+                ignores = up;
+                path[base] = '\0';
+                return 0;
+            }
+        }
+    }
+
+    if (*ep == '\0')
+    {
+        /* No wildcard components remain, search the directory */
+        strcpy(path+len, cp);
+        count = search_tree(path, flat);
+        ignores = up;
+        path[base] = '\0';
+        return count;
+    }
+
+    memcpy(comp, cp, ep-cp);
+    comp[ep-cp] = '\0';
+
+    /* A "**" component also matches no subdirectory at all */
+    globstar = (strcmp(comp, "**") == 0);
+    next = ep+1;
+    if (globstar)
+    {
+        /* Consecutive "**" components match the same as a single one */
+        while (next[0] == '*'  and  next[1] == '*'
+            and  (next[2] == '/'  or  next[2] == '\\'))
+            next += 3;
+
+        /* A "**" followed only by the filename searches the whole tree */
+        if (next[strcspn(next, "/\\")] == '\0')
+        {
+            strcpy(path+len, next);
+            count = search_tree(path, false);
+            ignores = up;
+            path[base] = '\0';
+            return count;
+        }
+
+        /* Do not expand a "**" again through a directory link */
+        if (opt.o_follow  and  not visit_dir(path, VISIT_GLOB))
+        {
+            ignores = up;
+            path[base] = '\0';
+            return 0;
+        }
+        count += search_path(path, next, true);
+        next = cp;
+    }
+
+    /* Read the ignore files of the directory */
+    if (opt.o_ignore)
+    {
+        ign_path(dir, path, len);
+        ignores = ign_enter("", dir);
+    }
+
+    /* Search each subdirectory matching the component */
+    strcpy(path+len, WILD_WIN32);
+    if (not stopped  and  findfirst32(path, A_DIRECTORY, &info))
+    {
+        do
+        {
+            const char *	name = info.fdata.cFileName;
+            size_t		n;
+
+            if (not enter_dir(&info.fdata)
+                or  (not globstar  and  not fpattern_matchn(comp, name))
+                or  (ignores != NULL  and  ign_match("", dir, &info.fdata)))
+                continue;
+
+            n = strlen(name);
+            if (len + n + 1 + strlen(next) >= 16*1024)
+            {
+                fprintf(stderr, "error: Filename pattern is too long\n");
+                continue;
+            }
+            memcpy(path+len, name, n);
+            path[len+n] = SEP_CHAR;
+            path[len+n+1] = '\0';
+
+            DL(printf("|search_path: [%.999s] [%.999s]\n", path, next));
+            count += search_path(path, next, flat  or  globstar);
+        } while (not stopped  and  findnext32(&info));
+        findclose32(&info);
+    }
+
+    ignores = up;
+    path[base] = '\0';
+    return count;
+}
+
+
+/*------------------------------------------------------------------------------
+* case_blind()
+*	Determine if the filesystem of pattern 'pat' looks up filenames
+*	regardless of case, as filename patterns are matched.  Sets 'perdir'
+*	if the directories of the filesystem can each be made case-sensitive
+*	(NTFS and ReFS), so that each must be checked with case_dir().
+*
+* Returns
+*	True if the filesystem is known to ignore case, otherwise false.
+*/
+
+static bool case_blind(const char *pat, bool *perdir)
+{
+    static const char *	names[] =
+        { "NTFS", "ReFS", "FAT", "FAT32", "exFAT", "CDFS", "UDF", NULL };
+    const char *	root = NULL;
+    int			i;
+    char		drive[3+1];
+    char		fsname[MAX_PATH+1];
+
+    if (pat[0] != '\0'  and  pat[1] == ':')
+    {
+        drive[0] = pat[0];
+        drive[1] = ':';
+        drive[2] = SEP_CHAR;
+        drive[3] = '\0';
+        root = drive;
+    }
+    else if ((pat[0] == '/'  or  pat[0] == '\\')  and  (pat[1] == '/'  or  pat[1] == '\\'))
+        return false;		/* Network share, unknown */
+
+    if (not GetVolumeInformationA(root, NULL, 0, NULL, NULL, NULL,
+            fsname, sizeof(fsname)))
+        return false;
+
+    for (i = 0;  names[i] != NULL;  i++)
+    {
+        if (_stricmp(fsname, names[i]) == 0)
+        {
+            *perdir = (i < 2);
+            return true;
+        }
+    }
+    DL(printf("|case_blind: %s: no\n", fsname));
+    return false;
+}
+
+
+/*------------------------------------------------------------------------------
+* globstars()
+*	Counts the "**" components in the first 'len' characters of directory
+*	prefix 's', counting consecutive "**" components as one.
+*
+* Returns
+*	Number of "**" components.
+*/
+
+static int globstars(const char *s, size_t len)
+{
+    const char *	ep;
+    const char *	end = s + len;
+    bool		last = false;
+    int			n = 0;
+
+    for ( ;  s < end;  s = ep+1)
+    {
+        ep = s + strcspn(s, "/\\");
+        if (ep > end)
+            ep = end;
+        if (ep-s == 2  and  s[0] == '*'  and  s[1] == '*')
+        {
+            if (not last)
+                n++;
+            last = true;
+        }
+        else if (ep > s)
+            last = false;
+    }
+    return n;
+}
+
+
+/*------------------------------------------------------------------------------
+* search()
+*	Searches for filenames that match pattern 'pat'.
+*	All found entries are printed to the output.
+*
+*	If the directory prefix of the pattern contains wildcards, only the
+*	subdirectories matching it are searched.  If it contains more than one
+*	"**" component, a directory can be reached by more than one expansion
+*	of the pattern (e.g., "**\x\**\*.c" reaches "x\x" twice), so the
+*	directories searched are recorded and each is searched only once.
+*
+*	If the filename contains no wildcards, it is looked up directly in each
+*	directory searched instead of reading all of the directory entries.
+*	This is done only on filesystems that ignore case, and in directories
+*	that have not been made case-sensitive, since a lookup could otherwise
+*	miss names that differ only in case.
+*
+* Returns
+*	Number of matching filenames found.
+*/
+
+uint64_t search(const char *pat)
+{
+    const char *	ip;
+    const char *	cp;
+    const char *	ep;
+    const char *	file;
+    size_t		len;
+    size_t		n = 0;
+    char		path[16*1024+1];
+
+    /* Keep the drive and root prefix as is */
+    if (pat[0] != '\0'  and  pat[1] == ':')
+        n = 2;
+    while (pat[n] == '/'  or  pat[n] == '\\')
+        n++;
+
+    /* Check for wildcards in the directory prefix */
+    ip = strrchr(pat, '/');
+    if (strrchr(pat, '\\') > ip)
+        ip = strrchr(pat, '\\');
+
+    /* Check for a filename without wildcards (or a trailing '.' or space,
+    which a lookup would ignore) */
+    if (ip != NULL)
+        file = ip+1;
+    else
+        file = pat+n;
+    len = strlen(file);
+    lookup_name = (len > 0  and  file[len-1] != '.'  and  file[len-1] != ' '
+        and  not wild_comp(file, len, WILD_FILE)  and  strpbrk(file, "<>\"") == NULL
+        and  case_blind(pat, &lookup_dirs));
+    DL(printf("|lookup_name=%d\n", lookup_name));
+
+    /* Forget the directories visited for the previous pattern */
+    if (visited.s_n > 0)
+    {
+        memset(visited.s_slots, 0, visited.s_size * sizeof(struct DirId));
+        visited.s_n = 0;
+    }
+    visit_once = (ip != NULL  and  ip > pat+n  and  globstars(pat+n, ip - (pat+n)) > 1);
+
+    if (ip == NULL  or  ip < pat+n  or  not wild_comp(pat+n, ip - (pat+n), WILD_DIR))
+        return search_tree(pat, false);
+
+    /* A directory prefix that names an existing directory is taken as is */
+    if (ip - pat >= sizeof(path))
+    {
+        fprintf(stderr, "error: Filename pattern is too long\n");
+        return 0;
+    }
+    memcpy(path, pat, ip - pat);
+    path[ip - pat] = '\0';
+    if (is_dir(path))
+        return search_tree(pat, false);
+
+    /* The search starts below the literal components preceding the first
+    wildcard component, as it does below a literal directory prefix */
+    for (cp = pat+n;  ;  cp = ep+1)
+    {
+        ep = cp + strcspn(cp, "/\\");
+        if (*ep == '\0'  or  wild_dir(cp, ep-cp))
+            break;
+    }
+    memcpy(path, pat, cp-pat);
+    path[cp-pat] = '\0';
+    return search_path(path, cp, false);
+}
+
+
+/*------------------------------------------------------------------------------
+* expand_dirs()
+*	Expands the compact listing read from stream 'in' (named 'fname') into
+*	plain pathnames, which are printed to the output.
+*
+* Returns
+*	Number of pathnames printed, or -1 if 'in' is not a compact listing.
+*/
+
+static long expand_dirs(FILE *in, const char *fname)
+{
+    long	count = 0;
+    size_t	len;
+    size_t	n;
+    char	prefix[16*1024+1];
+    char	line[16*1024+2+1];
+
+    /* Check the listing header line */
+    if (fgets(line, sizeof(line), in) == NULL  or
+            strncmp(line, DIRS_MAGIC, strlen(DIRS_MAGIC)) != 0)
+    {
+        fprintf(stderr, "%s: Not a compact listing: %s\n", prog, fname);
+        return -1;
+    }
+
+    prefix[0] = '\0';
+    while (fgets(line, sizeof(line), in) != NULL)
+    {
+        /* Strip the line terminator */
+        len = strlen(line);
+        while (len > 0  and  (line[len-1] == '\n'  or  line[len-1] == '\r'))
+            line[--len] = '\0';
+
+        if (line[0] != DIRS_CHAR)
+        {
+            /* Print an entry pathname */
+            out_puts(prefix);
+            out_put(line, len);
+            out_putc(opt.o_nulterm ? '\0' : '\n');
+            count++;
+            continue;
+        }
+
+        /* Decode a directory prefix record, "|N|suffix" */
+        for (n = 0, len = 1;  isdigit(line[len]);  len++)
+            n = n*10 + (line[len] - '0');
+
+        if (line[len] != DIRS_CHAR  or  n > strlen(prefix)  or
+                n + strlen(line+len+1) >= sizeof(prefix))
+        {
+            fprintf(stderr, "%s: Malformed prefix record in %s: %.80s\n",
+                prog, fname, line);
+            return -1;
+        }
+        strcpy(prefix+n, line+len+1);
+    }
+
+    return count;
+}
+
+
+/*------------------------------------------------------------------------------
+* get_le()
+*	Extracts an 'n' byte little-endian unsigned number from 'p'.
+*/
+
+static uint64_t get_le(const unsigned char *p, int n)
+{
+    uint64_t	v = 0;
+
+    while (n-- > 0)
+        v = (v << 8) | p[n];
+    return v;
+}
+
+
+/*------------------------------------------------------------------------------
+* expand_bin()
+*	Expands the binary listing read from stream 'in' (named 'fname') into
+*	pathnames, which are printed to the output, along with the details
+*	from each record for a long listing ('-l').
+*
+* Returns
+*	Number of pathnames printed, or -1 if 'in' is not a binary listing.
+*/
+
+static long expand_bin(FILE *in, const char *fname)
+{
+    long		count = 0;
+    unsigned char	rec[4+BIN_HDRSIZE];
+    char		path[16*1024+1];
+
+    /* Check the listing header */
+    if (fread(path, 1, BIN_MAGICLEN, in) != BIN_MAGICLEN  or
+            memcmp(path, BIN_MAGIC, BIN_MAGICLEN) != 0)
+    {
+        fprintf(stderr, "%s: Not a binary listing: %s\n", prog, fname);
+        return -1;
+    }
+
+    while (fread(rec, 1, 4, in) == 4)
+    {
+        size_t			len;
+        size_t			plen;
+        struct _FILETIME	ft;
+        uint64_t		t;
+
+        /* Read the next record */
+        len = (size_t) get_le(rec, 4);
+        if (len < BIN_HDRSIZE  or  len - BIN_HDRSIZE >= sizeof(path)  or
+                fread(rec+4, 1, BIN_HDRSIZE, in) != BIN_HDRSIZE  or
+                fread(path, 1, len - BIN_HDRSIZE, in) != len - BIN_HDRSIZE  or
+                (plen = (size_t) get_le(rec+24, 2)) > len - BIN_HDRSIZE)
+        {
+            fprintf(stderr, "%s: Malformed record in %s\n", prog, fname);
+            return -1;
+        }
+
+        /* Print the entry */
+        if (opt.o_longlist)
+        {
+            t = get_le(rec+12, 8);
+            ft.dwLowDateTime =  (DWORD) t;
+            ft.dwHighDateTime = (DWORD) (t >> 32);
+            print_details(get_le(rec+4, 8), (unsigned int) get_le(rec+20, 4), &ft);
+        }
+        out_put(path, plen);
+        out_putc(opt.o_nulterm ? '\0' : '\n');
+        count++;
+    }
+
+    return count;
+}
+
+
+/*------------------------------------------------------------------------------
+* expand()
+*	Expands listing file 'fname' ("-" is the standard input) into plain
+*	pathnames, which are printed to the output.
+*	The listing can be in any of the formats written by the '-F' option.
+*
+* Returns
+*	Number of pathnames printed, or -1 on error.
+*/
+
+static long expand(const char *fname)
+{
+    FILE *	in;
+    long	c;
+    int		ch;
+
+    /* Open the listing file */
+    if (strcmp(fname, "-") == 0)
+    {
+        in = stdin;
+        _setmode(_fileno(stdin), _O_BINARY);
+    }
+    else if ((in = fopen(fname, "rb")) == NULL)
+    {
+        fprintf(stderr, "%s: Cannot open: %s\n", prog, fname);
+        return -1;
+    }
+
+    /* Determine the listing format from its first byte */
+    ch = getc(in);
+    ungetc(ch, in);
+
+    if (ch == BIN_MAGIC[0])
+        c = expand_bin(in, fname);
+    else
+        c = expand_dirs(in, fname);
+
+    if (in != stdin)
+        fclose(in);
+    return c;
+}
+
+
+/*------------------------------------------------------------------------------
+* usage()
+*	Print a command usage message, then punt.
+*/
+
+static const char *	usage_m[] =
+{
+    "Options:",
+    "    -?          Show information about this program.",
+    "    -0          Terminate each printed name with a null character instead",
+    "                of a newline (for 'xargs -0').",
+#if DEBUG
+    "    -D          Enable debugging trace output.",
+#endif
+    "    -a          Print all matching entries.",
+    "    -A          Print all matching entries except \".\" and \"..\".",
+    "    -c          Print only the summary totals (as for '-n'), without the",
+    "                entries.",
+    "    -d[+|-|!]D  Find files modified [after|before|not] date D, which is of",
+    "                the form \"[YY]YY[-MM[-DD]][:HH[:MM[:SS]]]\",",
+    "                or is \"now\" (the current time), \"today\" (00:00 today),",
+    "                \"yesterday\", or \"tomorrow\".",
+    "                Two options can be given to specify a range of dates.",
+    "    -du N       Print the total bytes, blocks, and number of the matching",
+    "                entries within each directory and its subdirectories,",
+    "                instead of the entries, for directories at most N levels",
+    "                below the searched directory.",
+    "    -E          Expand the listing files (\"-\" is the standard input) named",
+    "                by the file arguments, as written by '-F', into pathnames.",
+    "                With '-l', the details stored in a binary listing are shown.",
+    "                With '-0', the pathnames are null-terminated.",
+    "    -est N      Print estimates of the number and total size of the",
+    "                matching entries, and of the number of directories, with",
+    "                their 95% confidence intervals, instead of the entries.",
+    "                The estimates are made by reading about N randomly chosen",
+    "                directories instead of searching the whole tree.",
+    "    -f          Show filenames without drive or path prefixes.",
+    "    -follow     Search the subdirectories that are directory links",
+    "                (junctions and symbolic links), skipping any directory",
+    "                already searched.  By default, links are not searched.",
+    "    -F fmt      Print the listing in format fmt, which is one of:",
+    "                    text   One pathname per line (default).",
+    "                    dirs   Compact, each directory prefix is printed once,",
+    "                           followed by the names of its matching entries.",
+    "                    front  Like 'dirs', but each directory prefix is",
+    "                           front-coded against the previous one.",
+    "                    bin    Binary records containing the size, modification",
+    "                           time, attributes, and pathname of each entry.",
+    "                    json   One JSON object per line, with \"path\", \"size\",",
+    "                           \"mtime\" (seconds since 1970-01-01 UTC), and",
+    "                           \"attr\" members, in UTF-8.",
+    "                The '-f', '-l', '-n', and '-v' options are ignored for the",
+    "                compact, binary, and JSON formats.",
+#ifdef is_unsupported
+|   "    -g[!]name   Owner group is [not] name.",
+|   "    -g[!]num    Owner group is [not] group-ID.",
+#endif
+    "    -group key  Print the total bytes and number of the matching entries",
+    "                for each value of key, by descending bytes, instead of",
+    "                the entries, where key is one of:",
+    "                    ext    File name extension (ignoring case).",
+    "                    owner  Owner account.",
+    "                    depth  Subdirectory depth (0 is the searched directory).",
+    "    -hist       Print histograms of the sizes and ages (since the last",
+    "                modification) of the matching entries, instead of the",
+    "                entries.",
+    "    -ignore     Skip the entries (and directories) listed in the",
+    "                '.gitignore' and '.vfindignore' files of the directories",
+    "                searched.  A '*' in a rule containing a '/' can also",
+    "                match across directories.",
+    "    -j N        Search subdirectories using N threads (at most 64).",
+    "                Entries are printed in the same order as for a single",
+    "                thread, unless '-U' is specified.",
+    "    -l          Long listing.",
+    "    -m          Show short DOS names.",
+    "    -max N      Stop searching after N matching entries are found.  With",
+    "                '-j', these are not necessarily the first N entries",
+    "                found by a single thread.",
+    "    -maxdepth N Do not search subdirectories more than N levels below the",
+    "                searched directory ('-maxdepth 0' is the same as '-r').",
+    "    -mindepth N Do not print the entries of directories less than N levels",
+    "                below the searched directory ('-mindepth 1' skips the",
+    "                entries of the searched directory itself).  These",
+    "                directories are still searched for subdirectories.",
+    "    -M N        Limit the memory used by '-o' to about N bytes (default",
+    "                64m); N can have a 'k', 'm', or 'g' suffix.  Entries that",
+    "                do not fit are sorted in temporary files.",
+    "    -n          Show list summary.",
+    "    -o key      Print the entries sorted by key, which is one of:",
+    "                    name   Pathname (ignoring case).",
+    "                    size   File size, then pathname.",
+    "                    mtime  Modification time, then pathname.",
+    "                    dir    File name, within each directory (the",
+    "                           directories are searched in the usual order).",
+    "                A leading '-' (e.g., '-size') sorts in descending order.",
+    "    -prune-match",
+    "                Do not search the subdirectories of a matching directory",
+    "                (e.g., \"-prune-match -t d node_modules\").",
+    "    -q          Print nothing, and stop searching at the first matching",
+    "                entry.  The exit status is 0 if any entry matches.",
+    "    -r          Do not recursively search subdirectories.",
+    "    -s[+|-|!]N  File size is [more|less|not] N bytes.",
+    "                N can have one of these suffixes:",
+    "                    k  Kilobytes (1,204 bytes)",
+    "                    m  Megabytes (1,048,576 bytes)",
+    "                    g  Gigabytes (1,073,741,824 bytes)",
+    "                Two options can be given to specify a lower and upper range of",
+    "                file sizes.",
+    "    -t[!]T      Find entries [not] of type T, which is one or more of these",
+    "                attributes combined (or-ed) together:",
+    "                    a  Archive          f  File             s  System",
+    "                    b  Device           h  Hidden           v  Virtual",
+    "                    c  Compressed       l  Volume label     w  Writable",
+    "                    d  Directory        o  Offline",
+    "                    e  Encrypted        r  Read only",
+#ifdef not_yet_supported
+|   "                Lowercase letters are or-ed together, uppercase letters are"
+|   "                and-ed together.",
+#endif
+#ifdef is_unsupported
+|   "    -u[!]name   Owner user is [not] name.",
+|   "    -u[!]num    Owner user is [not] user-ID.",
+#endif
+    "    -top N[:key]",
+    "                Print only the N entries with the largest key, largest",
+    "                first, where key is 'size' (default) or 'mtime' (the newest",
+    "                entries).  Use '-t f' to consider only files.",
+    "    -U          With '-j', print entries in the order they are found",
+    "                (fastest).",
+    "    -v          Verbose output.",
+#ifdef is_unsupported
+|   "    -w[+|-]n[T] Find files modified [before|after] the last n time periods,",
+|   "                where T is the optional time period type, one of:",
+|   "                    s  Seconds",
+|   "                    m  Minutes",
+|   "                    h  Hours",
+|   "                    d  Days (default)",
+|   "                    y  Years",
+#endif
+    "    -x pat      Do not search or print directories whose names match",
+    "                pattern pat.  This option can be given more than once.",
+#ifdef is_unsupported
+|   "    -z          Dates and times are UTC (Zulu timezone).",
+#endif
+    "",
+    "Filenames can contain wildcard characters:",
+    "    ?       Matches any single character (including '.').",
+    "    *       Matches zero or more characters (including '.').",
+    "    [abc]   Matches 'a', 'b', or 'c'.",
+    "    [a-z]   Matches 'a' through 'z'.",
+    "    [!a-z]  Matches any character except 'a' thru 'z'.",
+    "    {a,b}   Matches pattern 'a' or 'b' (e.g., \"*.{c,h}\").",
+    "    `X      Matches X exactly (X can be a wildcard character).",
+    "    !X      Matches any filename except X.",
+    "    **      As a whole directory component, matches zero or more",
+    "            subdirectories (e.g., \"build\\**\\gen\\*.h\"); only the files",
+    "            directly within the matching directories are then found.",
+    "",
+    "The directory prefix can contain wildcards too (e.g., \"src\\*\\test\\*.c\"),",
+    "in which case only the directories that match it are searched.",
+    "",
+    NULL
+};
+
+static void usage(void)
+{
+    int		i;
+
+    fprintf(stderr, "[%s, %s %s]\n\n",
+        ID_TITLE, ID_VERS, ID_DATE);
+
+    fprintf(stderr, "Find matching filenames in a directory tree.\n\n");
+
+    fprintf(stderr, "usage:  %s [option...] [path" SEP_STR "]file...\n",
+        prog);
+    fprintf(stderr, "        %s -E [option...] listfile...\n\n",
+        prog);
+
+    for (i = 0;  usage_m[i] != NULL;  i++)
+        fprintf(stderr, "%s\n", usage_m[i]);
+
+    exit(RC_USAGE);
+}
+
+
+/*------------------------------------------------------------------------------
+* about()
+*	Print an 'about' message, then punt.
+*/
+
+static const char *	about_m[] =
+{
+    ID_COMPILE,
+#if DEBUG
+    "(with debugs)",
+#endif
+    "",
+    COPYRIGHT+4,
+    "",
+    "This software may be freely distributed.  However, duplication and/or",
+    "distribution of this software for financial gain without prior written",
+    "consent of the author is prohibited.",
+    "",
+    "    David R. Tribble",
+    "    " ID_C_EMAIL,
+    "    " ID_C_HOME,
+    NULL
+};
+
+static void about(void)
+{
+    int		i;
+
+    for (i = 0;  about_m[i] != NULL;  i++)
+        fprintf(stderr, "%s\n", about_m[i]);
+
+    exit(RC_OKAY);
+}
+
+
+/*------------------------------------------------------------------------------
+* parse_date()
+*	Parses date/time specification 'arg'.
+*	Unspecified parts are assumed to be the earliest unit.
+*
+* Lexicon
+*	[CC] YY [ [-]MM [ [-]DD] ] [ [:]HH [ [:]MM [ [:]SS ] ] ]
+*
+* Returns
+*	True if the specification was of correct syntax, otherwise false.
+*/
+
+static bool parse_date(const char *arg, struct _FILETIME *ft)
+{
+    bool		special;
+    int			j;
+    long		v;
+    struct _SYSTEMTIME	now;
+    struct _SYSTEMTIME	st;
+
+    /* Get the current time */
+    if (opt.o_utczone)
+        GetSystemTime(&now);
+    else
+        GetLocalTime(&now);
+
+    DL(printf("|now:  %04d-%02d-%02d %02d:%02d:%02d %s\n",
+        now.wYear, now.wMonth, now.wDay,
+        now.wHour, now.wMinute, now.wSecond,
+        (opt.o_utczone ? "Z" : "LOC")));
+
+    st = now;
+    st.wHour =   0;
+    st.wMinute = 0;
+    st.wSecond = 0;
+
+    /* Parse the date spec */
+
+    /* Check for special date keywords */
+    special = false;
+    while (arg[0] != '\0'  and  not isalnum(arg[0]))
+        arg++;
+
+    if (strcmp(arg, "now") == 0  or  strcmp(arg, ".") == 0)
+    {
+        st.wHour =   now.wHour;
+        st.wMinute = now.wMinute;
+        st.wSecond = now.wSecond;
+
+        SystemTimeToFileTime(&st, ft);
+        special = true;
+    }
+    else if (strcmp(arg, "today") == 0  or  strcmp(arg, "tod") == 0)
+    {
+        SystemTimeToFileTime(&st, ft);
+        special = true;
+    }
+    else if (strcmp(arg, "yesterday") == 0  or  strcmp(arg, "yest") == 0)
+    {
+        uint64_t	ftime;
+
+        SystemTimeToFileTime(&st, ft);
+        ftime = ((uint64_t)ft->dwHighDateTime << 32) + ft->dwLowDateTime;
+        ftime -= TICKS_PER_DAY;
+        ft->dwLowDateTime =  (DWORD) ftime;
+        ft->dwHighDateTime = (DWORD) (ftime >> 32);
+        DL(FileTimeToSystemTime(ft, &st));
+        special = true;
+    }
+    else if (strcmp(arg, "tomorrow") == 0  or  strcmp(arg, "tom") == 0)
+    {
+        uint64_t	ftime;
+
+        SystemTimeToFileTime(&st, ft);
+        ftime = ((uint64_t)ft->dwHighDateTime << 32) + ft->dwLowDateTime;
+        ftime += TICKS_PER_DAY;
+        ft->dwLowDateTime =  (DWORD) ftime;
+        ft->dwHighDateTime = (DWORD) (ftime >> 32);
+        DL(FileTimeToSystemTime(ft, &st));
+        special = true;
+    }
+
+    if (special)
+    {
+        DL(printf("|date: %04d-%02d-%02d %02d:%02d:%02d =%08X:%08X\n",
+            st.wYear, st.wMonth, st.wDay,
+            st.wHour, st.wMinute, st.wSecond,
+            ft->dwHighDateTime, ft->dwLowDateTime));
+        return true;
+    }
+
+    /* Get the year '[CC]YY' part */
+    while (arg[0] != '\0'  and  not isdigit(arg[0]))
+        arg++;
+    if (isdigit(arg[0]))
+    {
+        for (v = j = 0;  j < 4  and  isdigit(arg[j]);  j++)
+            v = v*10 + (arg[j] - '0');
+        arg += j;
+        v = (v > 100 ? v : v + 2000);
+
+        st.wYear =   v;
+        st.wMonth =  1;
+        st.wDay =    1;
+        st.wHour =   0;
+        st.wMinute = 0;
+        st.wSecond = 0;
+    }
+    else
+        return false;
+
+    /* Get the month 'MM' part */
+    while (arg[0] != '\0'  and  not isdigit(arg[0]))
+        arg++;
+    if (isdigit(arg[0]))
+    {
+        for (v = j = 0;  j < 2  and  isdigit(arg[j]);  j++)
+            v = v*10 + (arg[j] - '0');
+        arg += j;
+
+        st.wMonth = v;
+        st.wDay =   1;
+    }
+
+    /* Get the day 'DD' part */
+    while (arg[0] != '\0'  and  not isdigit(arg[0]))
+        arg++;
+    if (isdigit(arg[0]))
+    {
+        for (v = j = 0;  j < 2  and  isdigit(arg[j]);  j++)
+            v = v*10 + (arg[j] - '0');
+        arg += j;
+
+        st.wDay = v;
+    }
+
+    /* Get the hour 'HH' part */
+    while (arg[0] != '\0'  and  not isdigit(arg[0]))
+        arg++;
+    if (isdigit(arg[0]))
+    {
+        for (v = j = 0;  j < 2  and  isdigit(arg[j]);  j++)
+            v = v*10 + (arg[j] - '0');
+        arg += j;
+
+        st.wHour =   v;
+        st.wMinute = 0;
+        st.wSecond = 0;
+    }
+
+    /* Get the minute 'MM' part */
+    while (arg[0] != '\0'  and  not isdigit(arg[0]))
+        arg++;
+    if (isdigit(arg[0]))
+    {
+        for (v = j = 0;  j < 2  and  isdigit(arg[j]);  j++)
+            v = v*10 + (arg[j] - '0');
+        arg += j;
+
+        st.wMinute = v;
+        st.wSecond = 0;
+    }
+
+    /* Get the second 'SS' part */
+    while (arg[0] != '\0'  and  not isdigit(arg[0]))
+        arg++;
+    if (isdigit(arg[0]))
+    {
+        for (v = j = 0;  j < 2  and  isdigit(arg[j]);  j++)
+            v = v*10 + (arg[j] - '0');
+        arg += j;
+
+        st.wSecond = v;
+    }
+
+    DL(printf("|date: %04d-%02d-%02d %02d:%02d:%02d\n",
+        st.wYear, st.wMonth, st.wDay,
+        st.wHour, st.wMinute, st.wSecond));
+
+    /* Convert broken-down system date/time into a filestamp time */
+    /* Note: Do NOT adjust for local time here */
+    if (not SystemTimeToFileTime(&st, ft))
+        return false;
+    return true;
+}
+
+
+/*------------------------------------------------------------------------------
+* parse_size()
+*	Parses file size specification 'arg'.
+*
+* Returns
+*	True if specification was of correct syntax, otherwise false.
+*/
+
+static bool parse_size(const char *arg, uint64_t *sz)
+{
+    int		j;
+    uint64_t	v;
+
+    /* Parse the size spec */
+    while (arg[0] != '\0'  and  not isdigit(arg[0]))
+        arg++;
+
+    v = 0;
+    for (j = 0;  arg[j] != '\0';  j++)
+    {
+        if (isdigit(arg[j]))
+        {
+            uint64_t	p;
+
+            p = v;
+            v = v*10 + (arg[j] - '0');
+
+            if (p > v)
+                return false;
+        }
+    }
+
+    /* Parse numeric suffix, if any */
+    switch (tolower(arg[j-1]))
+    {
+    case 'k':
+        v *= 1024LL;
+        break;
+    case 'm':
+        v *= 1024*1024LL;
+        break;
+    case 'g':
+        v *= 1024*1024*1024LL;
+        break;
+    }
+
+    DL(printf("|size: %I64u\n", v));
+
+    *sz = v;
+    return true;
+}
+
+
+/*------------------------------------------------------------------------------
+* parse_opts()
+*	Parse the command line options.
+*
+* Returns
+*	The number of args consumed.
+*/
+
+static int parse_opts(int argc, const char **argv)
+{
+    int			i = 0;
+    int			nexti;
+    int			optch;
+    const char *	optarg;
+
+#if DEBUG
+    /* Print the command line args */
+    for (i = 0;  i < argc;  i++)
+        DL(printf("|argv[%2d]='%s'\n", i, argv[i]));
+#endif
+
+    /* Pre-parse the command line options, looking for '-D' (debug) */
+    for (i = 1;  i < argc  and  argv[i][0] == '-'  and  argv[i][1] != '\0';  i++)
+    {
+        if (strcmp(argv[i], "-D") == 0)
+            opt_debug = true;
+    }
+
+    /* Parse the command line options */
+    opt.o_maxdepth = -1;
+    for (i = 1;  i < argc  and  argv[i][0] == '-'  and  argv[i][1] != '\0';  i++)
+    {
+        nexti = i+1;
+
+        /* Check for word options */
+        if (strcmp(argv[i], "-top") == 0)
+        {
+            /* Top entries */
+            opt.o_top = (argv[i+1] != NULL ? argv[i+1] : "");
+            DL(printf("|-top '%s'\n", opt.o_top));
+            nexti = i+2;
+            goto nextarg;
+        }
+        else if (strcmp(argv[i], "-hist") == 0)
+        {
+            /* Size and age histograms */
+            DL(printf("|-hist\n"));
+            opt.o_hist = true;
+            opt.o_nolist = true;
+            continue;
+        }
+        else if (strcmp(argv[i], "-group") == 0)
+        {
+            /* Group-by totals */
+            opt.o_groupby = (argv[i+1] != NULL ? argv[i+1] : "");
+            DL(printf("|-group '%s'\n", opt.o_groupby));
+            opt.o_nolist = true;
+            nexti = i+2;
+            goto nextarg;
+        }
+        else if (strcmp(argv[i], "-est") == 0)
+        {
+            /* Estimate totals by sampling */
+            optarg = (argv[i+1] != NULL ? argv[i+1] : "");
+            DL(printf("|-est '%s'\n", optarg));
+            opt.o_estreads = atol(optarg);
+            if (opt.o_estreads <= 0)
+            {
+                fprintf(stderr, "%s: Improper directory count '%s'\n\n",
+                    prog, optarg);
+                usage();
+            }
+            nexti = i+2;
+            goto nextarg;
+        }
+        else if (strcmp(argv[i], "-max") == 0)
+        {
+            /* Stop after N matches */
+            optarg = (argv[i+1] != NULL ? argv[i+1] : "");
+            DL(printf("|-max '%s'\n", optarg));
+            opt.o_max = atol(optarg);
+            if (opt.o_max <= 0)
+            {
+                fprintf(stderr, "%s: Improper match count '%s'\n\n",
+                    prog, optarg);
+                usage();
+            }
+            nexti = i+2;
+            goto nextarg;
+        }
+        else if (strcmp(argv[i], "-maxdepth") == 0
+            or  strcmp(argv[i], "-mindepth") == 0)
+        {
+            /* Subdirectory depth limits */
+            optarg = (argv[i+1] != NULL ? argv[i+1] : "");
+            DL(printf("|%s '%s'\n", argv[i], optarg));
+            if (not isdigit(optarg[0]))
+            {
+                fprintf(stderr, "%s: Improper depth '%s'\n\n", prog, optarg);
+                usage();
+            }
+            if (argv[i][2] == 'a')
+                opt.o_maxdepth = atoi(optarg);
+            else
+                opt.o_mindepth = atoi(optarg);
+            nexti = i+2;
+            goto nextarg;
+        }
+        else if (strcmp(argv[i], "-prune-match") == 0)
+        {
+            /* Do not search matching directories */
+            DL(printf("|-prune-match\n"));
+            opt.o_prunematch = true;
+            continue;
+        }
+        else if (strcmp(argv[i], "-follow") == 0)
+        {
+            /* Follow directory links */
+            DL(printf("|-follow\n"));
+            opt.o_follow = true;
+            continue;
+        }
+        else if (strcmp(argv[i], "-ignore") == 0)
+        {
+            /* Skip entries listed in ignore files */
+            DL(printf("|-ignore\n"));
+            opt.o_ignore = true;
+            continue;
+        }
+        else if (strcmp(argv[i], "-du") == 0)
+        {
+            /* Directory usage totals */
+            optarg = (argv[i+1] != NULL ? argv[i+1] : "");
+            DL(printf("|-du '%s'\n", optarg));
+            opt.o_du = true;
+            opt.o_nolist = true;
+            opt.o_dudepth = atoi(optarg);
+            if (not isdigit(optarg[0]))
+            {
+                fprintf(stderr, "%s: Improper depth '%s'\n\n", prog, optarg);
+                usage();
+            }
+            nexti = i+2;
+            goto nextarg;
+        }
+
+        for ( ;  argv[i][1] != '\0';  argv[i]++)
+        {
+            optch = argv[i][1];
+
+            if (argv[i][2] != '\0')
+                optarg = &argv[i][2];
+            else if (argv[i+1] == NULL)
+                optarg = "";
+            else
+            {
+                optarg = argv[i+1];
+                nexti = i+2;
+            }
+
+            DL(printf("|argv[%d]: optch='%c' optarg='%s'\n", i, optch, optarg));
+
+            switch (optch)
+            {
+            case '?':
+                /* Print info about this program */
+                about();
+                break;
+
+            case '0':
+                /* Null-terminated names */
+                DL(printf("|-0\n"));
+                opt.o_nulterm = true;
+                break;
+
+            case 'a':
+                /* All files, including hidden ones */
+                DL(printf("|-a\n"));
+                opt.o_all = true;
+                break;
+
+            case 'A':
+                /* All files, including hidden ones, except "." and ".." */
+                DL(printf("|-A\n"));
+                opt.o_almostall = true;
+                break;
+
+            case 'c':
+                /* Count totals only */
+                DL(printf("|-c\n"));
+                opt.o_count = true;
+                break;
+
+            case 'd':
+                /* Date specification(s) */
+                DL(printf("|-d '%s'\n", optarg));
+                if (opt.o_date1 != NULL)
+                    opt.o_date2 = opt.o_date1;
+                opt.o_date1 = optarg;
+                goto nextarg;
+
+            case 'D':
+                /* Enable debugging trace output */
+                DL(printf("|-D\n"));
+                opt_debug = true;
+                break;
+
+            case 'E':
+                /* Expand listing files */
+                DL(printf("|-E\n"));
+                opt.o_expand = true;
+                break;
+
+            case 'f':
+                /* Show filenames without drive/path prefixes */
+                DL(printf("|-f\n"));
+                opt.o_nameonly = true;
+                break;
+
+            case 'F':
+                /* Output listing format */
+                DL(printf("|-F '%s'\n", optarg));
+                opt.o_fmt = optarg;
+                goto nextarg;
+
+            case 'g':
+                /* Owner group name */
+                DL(printf("|-g '%s'\n", optarg));
+                opt.o_group = optarg;
+                goto nextarg;
+
+            case 'j':
+                /* Parallel search threads */
+                DL(printf("|-j '%s'\n", optarg));
+                opt.o_jobs = atoi(optarg);
+                if (opt.o_jobs < 1  or  opt.o_jobs > MAX_JOBS)
+                {
+                    fprintf(stderr, "%s: Improper thread count '%s'\n\n",
+                        prog, optarg);
+                    usage();
+                }
+                goto nextarg;
+
+            case 'l':
+                /* Long (verbose) listing */
+                DL(printf("|-l\n"));
+                opt.o_longlist = true;
+                break;
+
+            case 'm':
+                /* Use short MS-DOS names */
+                DL(printf("|-m\n"));
+                opt.o_dosnames = true;
+                break;
+
+            case 'M':
+                /* Sort memory cap */
+                DL(printf("|-M '%s'\n", optarg));
+                if (not parse_size(optarg, &opt.o_sortmem)
+                    or  opt.o_sortmem == 0)
+                {
+                    fprintf(stderr, "%s: Improper size specification '%s'\n\n",
+                        prog, optarg);
+                    usage();
+                }
+                goto nextarg;
+
+            case 'n':
+                /* Show list summary */
+                DL(printf("|-n\n"));
+                opt.o_summary = true;
+                break;
+
+            case 'o':
+                /* Sorted output */
+                DL(printf("|-o '%s'\n", optarg));
+                opt.o_sortkey = optarg;
+                goto nextarg;
+
+            case 'q':
+                /* Quiet, exit status only */
+                DL(printf("|-q\n"));
+                opt.o_quiet = true;
+                break;
+
+            case 'r':
+                /* Do not search subdirectories */
+                DL(printf("|-r\n"));
+                opt.o_nosubdirs = true;
+                break;
+
+            case 's':
+                /* Size specification */
+                DL(printf("|-s '%s'\n", optarg));
+                if (opt.o_size1 != NULL)
+                {
+                    opt.o_size2 = opt.o_size1;
+                    opt.o_size2_v = opt.o_size1_v;
+                }
+
+                opt.o_size1 = optarg;
+                if (not parse_size(optarg, &opt.o_size1_v))
+                {
+                    fprintf(stderr, "%s: Improper size specification '%s'\n\n",
+                        prog, optarg);
+                    usage();
+                }
+                goto nextarg;
+
+            case 't':
+                /* Entry type */
+                DL(printf("|-t '%s'\n", optarg));
+                opt.o_type = optarg;
+                goto nextarg;
+
+            case 'u':
+                /* Owner user name */
+                DL(printf("|-u '%s'\n", optarg));
+                opt.o_user = optarg;
+                goto nextarg;
+
+            case 'U':
+                /* Unordered parallel output */
+                DL(printf("|-U\n"));
+                opt.o_unordered = true;
+                break;
+
+            case 'v':
+                /* Verbose output */
+                DL(printf("|-v\n"));
+                opt.o_verbose = true;
+                break;
+
+            case 'x':
+                /* Excluded directory pattern */
+                DL(printf("|-x '%s'\n", optarg));
+                if (opt.o_nexcl >= MAX_EXCL)
+                {
+                    fprintf(stderr, "%s: Too many '-x' patterns\n\n", prog);
+                    usage();
+                }
+                if (not fpattern_isvalid(optarg))
+                {
+                    fprintf(stderr, "%s: Ill-formed filename pattern '%s'\n\n",
+                        prog, optarg);
+                    usage();
+                }
+                opt.o_excl[opt.o_nexcl++] = optarg;
+                goto nextarg;
+
+            case 'z':
+                /* UTC dates/times */
+                DL(printf("|-z\n"));
+                opt.o_utczone = true;
+                break;
+
+            default:
+                /* Unknown option */
+                DL(printf("|bad option '%c'\n", optch));
+                fprintf(stderr, "%s: Bad option '-%c'\n\n", prog, optch);
+                usage();
+            }
+        }
+
+        continue;
+
+nextarg:
+        DL(printf("|nextarg %d\n", nexti));
+        i = nexti-1;
+    }
+
+    /* Parse the date options, if any */
+    if (opt.o_date1 != NULL)
+    {
+        if (not parse_date(opt.o_date1, &opt.o_date1_v))
+        {
+            fprintf(stderr, "%s: Improper date specification '%s'\n\n",
+                prog, opt.o_date1);
+            usage();
+        }
+    }
+
+    if (opt.o_date2 != NULL)
+    {
+        if (not parse_date(opt.o_date2, &opt.o_date2_v))
+        {
+            fprintf(stderr, "%s: Improper date specification '%s'\n\n",
+                prog, opt.o_date2);
+            usage();
+        }
+    }
+
+    /* Parse the output format, if any */
+    opt.o_format = FMT_TEXT;
+    if (opt.o_fmt == NULL  or  strcmp(opt.o_fmt, "text") == 0)
+        opt.o_format = FMT_TEXT;
+    else if (strcmp(opt.o_fmt, "dirs") == 0)
+        opt.o_format = FMT_DIRS;
+    else if (strcmp(opt.o_fmt, "front") == 0)
+        opt.o_format = FMT_FRONT;
+    else if (strcmp(opt.o_fmt, "bin") == 0)
+        opt.o_format = FMT_BIN;
+    else if (strcmp(opt.o_fmt, "json") == 0)
+        opt.o_format = FMT_JSON;
+    else
+    {
+        fprintf(stderr, "%s: Unknown output format '%s'\n\n",
+            prog, opt.o_fmt);
+        usage();
+    }
+
+    /* Parse the sort key, if any */
+    opt.o_sort = SORT_NONE;
+    if (opt.o_sortkey != NULL)
+    {
+        const char *	key = opt.o_sortkey;
+
+        opt.o_sortrev = (key[0] == '-');
+        if (opt.o_sortrev)
+            key++;
+
+        if (strcmp(key, "name") == 0)
+            opt.o_sort = SORT_NAME;
+        else if (strcmp(key, "size") == 0)
+            opt.o_sort = SORT_SIZE;
+        else if (strcmp(key, "mtime") == 0)
+            opt.o_sort = SORT_MTIME;
+        else if (strcmp(key, "dir") == 0)
+            opt.o_sort = SORT_DIR;
+        else
+        {
+            fprintf(stderr, "%s: Unknown sort key '%s'\n\n",
+                prog, opt.o_sortkey);
+            usage();
+        }
+    }
+
+    if (opt.o_sortmem == 0)
+        opt.o_sortmem = SORT_MEMCAP;
+
+    /* Parse the top entries spec, if any */
+    if (opt.o_top != NULL)
+    {
+        char *		end;
+        long		n;
+
+        n = strtol(opt.o_top, &end, 10);
+        if (opt.o_sortkey != NULL)
+        {
+            fprintf(stderr, "%s: Options '-o' and '-top' cannot be combined\n\n",
+                prog);
+            usage();
+        }
+
+        opt.o_sort = SORT_SIZE;
+        if (end[0] == ':'  and  strcmp(end+1, "mtime") == 0)
+            opt.o_sort = SORT_MTIME;
+        else if (end[0] != '\0'  and  strcmp(end, ":size") != 0)
+            n = 0;
+
+        if (n <= 0  or  end == opt.o_top)
+        {
+            fprintf(stderr, "%s: Improper top entries specification '%s'\n\n",
+                prog, opt.o_top);
+            usage();
+        }
+
+        /* The best entries are the first ones in descending order */
+        opt.o_topn = n;
+        opt.o_sortrev = true;
+    }
+
+    /* Directory usage totals are printed in order */
+    if (opt.o_du)
+        opt.o_unordered = false;
+
+    /* Parse the group-by key, if any */
+    opt.o_groupkey = GROUP_NONE;
+    if (opt.o_groupby == NULL)
+        ;
+    else if (strcmp(opt.o_groupby, "ext") == 0)
+        opt.o_groupkey = GROUP_EXT;
+    else if (strcmp(opt.o_groupby, "owner") == 0)
+        opt.o_groupkey = GROUP_OWNER;
+    else if (strcmp(opt.o_groupby, "depth") == 0)
+        opt.o_groupkey = GROUP_DEPTH;
+    else
+    {
+        fprintf(stderr, "%s: Unknown group key '%s'\n\n",
+            prog, opt.o_groupby);
+        usage();
+    }
+
+    /* Get the current time, for the age histogram */
+    if (opt.o_hist)
+    {
+        struct _FILETIME	ft;
+
+        GetSystemTimeAsFileTime(&ft);
+        opt.o_now = ((uint64_t)ft.dwHighDateTime << 32) + ft.dwLowDateTime;
+    }
+
+    if (opt.o_format != FMT_TEXT)
+    {
+        /* Compact, binary, and JSON listings contain only entry records */
+        opt.o_longlist = false;
+        opt.o_nameonly = false;
+        opt.o_summary =  false;
+        opt.o_verbose =  false;
+    }
+
+    if (opt.o_count)
+    {
+        /* Print the summary totals without the entries */
+        opt.o_summary = true;
+        opt.o_nolist = true;
+    }
+
+    if (opt.o_estreads > 0)
+    {
+        struct _FILETIME	ft;
+
+        /* Print only the estimates, from randomly chosen directories */
+        opt.o_summary = false;
+        opt.o_nolist = true;
+        GetSystemTimeAsFileTime(&ft);
+        est_seed = ((uint64_t)ft.dwHighDateTime << 32) + ft.dwLowDateTime;
+        est_seed |= 1;
+    }
+
+    if (opt.o_quiet)
+    {
+        /* Print nothing, only stop at the first match */
+        opt.o_max = 1;
+        opt.o_format = FMT_TEXT;
+        opt.o_summary = false;
+        opt.o_verbose = false;
+        opt.o_sort = SORT_NONE;
+        opt.o_topn = 0;
+        opt.o_du = false;
+        opt.o_hist = false;
+        opt.o_groupkey = GROUP_NONE;
+        opt.o_estreads = 0;
+        opt.o_nolist = true;
+    }
+
+    /* Parse the type attributes, if any */
+    opt.o_typemask = 0;
+    if (opt.o_type != NULL)
+    {
+        /* Check for or'ed criteria */
+        if (strchr(opt.o_type, 'a') != NULL)
+            opt.o_typemask |= A_ARCHIVE;
+        if (strchr(opt.o_type, 'b') != NULL)
+            opt.o_typemask |= A_DEVICE;
+        if (strchr(opt.o_type, 'c') != NULL)
+            opt.o_typemask |= A_COMPRESSED;
+        if (strchr(opt.o_type, 'd') != NULL)
+            opt.o_typemask |= A_DIRECTORY;
+        if (strchr(opt.o_type, 'e') != NULL)
+            opt.o_typemask |= A_ENCRYPTED;
+        if (strchr(opt.o_type, 'f') != NULL)
+            opt.o_typemask |= AX_NORMAL;
+        if (strchr(opt.o_type, 'h') != NULL)
+            opt.o_typemask |= A_HIDDEN;
+        if (strchr(opt.o_type, 'l') != NULL)
+            opt.o_typemask |= A_VOLUME;
+        if (strchr(opt.o_type, 'o') != NULL)
+            opt.o_typemask |= A_OFFLINE;
+        if (strchr(opt.o_type, 'r') != NULL)
+            opt.o_typemask |= A_READONLY;
+        if (strchr(opt.o_type, 's') != NULL)
+            opt.o_typemask |= A_SYSTEM;
+        if (strchr(opt.o_type, 't') != NULL)
+            opt.o_typemask |= A_TEMPORARY;
+        if (strchr(opt.o_type, 'v') != NULL)
+            opt.o_typemask |= A_VIRTUAL;
+        if (strchr(opt.o_type, 'w') != NULL)
+            opt.o_typemask |= AX_WRITABLE;
+
+        DL(printf("opt.o_typemask=%08lX\n", opt.o_typemask));
+
+#ifdef not_yet_supported
+        /* Check for and'ed (required) criteria */
+        if (strchr(opt.o_type, 'A') != NULL)
+            opt.o_typemask2 |= A_ARCHIVE;
+        if (strchr(opt.o_type, 'B') != NULL)
+            opt.o_typemask2 |= A_DEVICE;
+        if (strchr(opt.o_type, 'C') != NULL)
+            opt.o_typemask2 |= A_COMPRESSED;
+        if (strchr(opt.o_type, 'D') != NULL)
+            opt.o_typemask2 |= A_DIRECTORY;
+        if (strchr(opt.o_type, 'E') != NULL)
+            opt.o_typemask2 |= A_ENCRYPTED;
+        if (strchr(opt.o_type, 'F') != NULL)
+            opt.o_typemask2 |= AX_NORMAL;
+        if (strchr(opt.o_type, 'H') != NULL)
+            opt.o_typemask2 |= A_HIDDEN;
+        if (strchr(opt.o_type, 'L') != NULL)
+            opt.o_typemask2 |= A_VOLUME;
+        if (strchr(opt.o_type, 'O') != NULL)
+            opt.o_typemask2 |= A_OFFLINE;
+        if (strchr(opt.o_type, 'R') != NULL)
+            opt.o_typemask2 |= A_READONLY;
+        if (strchr(opt.o_type, 'S') != NULL)
+            opt.o_typemask2 |= A_SYSTEM;
+        if (strchr(opt.o_type, 'T') != NULL)
+            opt.o_typemask2 |= A_TEMPORARY;
+        if (strchr(opt.o_type, 'V') != NULL)
+            opt.o_typemask2 |= A_VIRTUAL;
+        if (strchr(opt.o_type, 'W') != NULL)
+            opt.o_typemask2 |= AX_WRITABLE;
+
+        DL(printf("opt.o_typemask2=%08lX\n", opt.o_typemask2));
+#endif
+    }
+
+    DL(printf("|%d args parsed\n", i));
+    return i;
+}
+
+
+/*------------------------------------------------------------------------------
+* main()
+*/
+
+int main(int argc, char **argv)
+{
+    int		i;
+    uint64_t	c;
+    uint64_t	tot_ent =	0;
+    uint64_t	tot_dir =	0;
+    uint64_t	tot_file =	0;
+    uint64_t	tot_visib =	0;
+    uint64_t	tot_byte =	0;
+    uint64_t	tot_block =	0;
+    char	c_ent[30+1];
+    char	c_dir[30+1];
+    char	c_file[30+1];
+    char	c_byte[30+1];
+    char	c_block[30+1];
+    char	c_visib[30+1];
+
+    DL(printf("|========================================\n"));
+
+    /* Get options */
+    i = parse_opts(argc, argv);
+    argc -= i;
+    argv += i;
+
+    DL(printf("|========================================\n"));
+
+    /* Check usage */
+    if (argc < 1)
+        usage();
+
+    /* Start the output writer */
+    out_init(stdout, not opt_debug);
+    atexit(out_term);
+
+    if (opt.o_ignore)
+        InitializeCriticalSection(&ignq.c_lock);
+    InitializeCriticalSection(&visited.s_lock);
+
+    if (opt.o_sort != SORT_NONE)
+    {
+        InitializeCriticalSection(&runs.l_lock);
+        atexit(sort_term);
+
+        for (i = 0;  i < 256;  i++)
+            sort_fold[i] = (unsigned char) tolower(i);
+    }
+
+    /* Expand listing files */
+    if (opt.o_expand)
+    {
+        c = 0;
+        for (i = 0;  i < argc;  i++)
+        {
+            long	n;
+
+            if ((n = expand(argv[i])) > 0)
+                c += n;
+        }
+
+        out_term();
+        return out_status(c > 0 ? RC_OKAY : RC_ERR);
+    }
+
+    /* Begin a compact or binary listing */
+    if (opt.o_format == FMT_DIRS  or  opt.o_format == FMT_FRONT)
+        out_puts(DIRS_MAGIC "\n");
+    else if (opt.o_format == FMT_BIN)
+    {
+        _setmode(_fileno(stdout), _O_BINARY);
+        out_put(BIN_MAGIC, BIN_MAGICLEN);
+    }
+    else if (opt.o_format == FMT_JSON  or  opt.o_nulterm)
+        _setmode(_fileno(stdout), _O_BINARY);
+
+    /* Search for matching entries */
+    for (i = 0;  i < argc;  i++)
+    {
+        memset(&count, 0, sizeof(count));
+
+//FIXME: too many newlines; TEST THIS
+        if (opt.o_summary  and  i > 0)
+            out_putc('\n');
+
+        c = search(argv[i]);
+        if (opt.o_topn > 0)
+            top_print();
+        else if (opt.o_sort != SORT_NONE  and  opt.o_sort != SORT_DIR)
+            sort_print();
+
+        /* Print totals */
+        if (opt.o_summary)
+        {
+            s_size(c, c_ent);
+            s_size(count.c_dir, c_dir);
+            s_size(count.c_file, c_file);
+            s_size(c - count.c_hidden, c_visib);
+            s_size(count.c_bytes, c_byte);
+            s_size(count.c_blocks, c_block);
+
+            if (c > 0  and  not opt.o_nolist)
+                out_putc('\n');
+            out_printf(" Entries:     %12s  (%s)\n",
+                c_ent, c_visib);
+            out_printf(" Directories: %12s  Files:  %12s\n",
+                c_dir, c_file);
+            out_printf(" Bytes:    %15s  Blocks: %12s\n",
+                c_byte, c_block);
+        }
+
+        /* Print histograms */
+        if (opt.o_hist)
+            hist_print(&count);
+
+        /* Print group-by totals */
+        if (opt.o_groupkey != GROUP_NONE)
+            group_print();
+
+        tot_ent   += c;
+        tot_dir   += count.c_dir;
+        tot_file  += count.c_file;
+        tot_visib += c - count.c_hidden;
+        tot_byte  += count.c_bytes;
+        tot_block += count.c_blocks;
+
+        /* Stop once the '-max' limit is reached or the output fails */
+        if (stopped)
+            break;
+    }
+
+    /* Print grand totals */
+    if (opt.o_summary  and  argc > 1)
+    {
+        s_size(tot_ent, c_ent);
+        s_size(tot_dir, c_dir);
+        s_size(tot_file, c_file);
+        s_size(tot_byte, c_byte);
+        s_size(tot_block, c_block);
+        s_size(tot_visib, c_visib);
+
+        out_putc('\n');
+        out_printf(" Total Entries:     %12s  (%s)\n",
+            c_ent, c_visib);
+        out_printf(" Total Directories: %12s  Files:  %12s\n",
+            c_dir, c_file);
+        out_printf(" Total Bytes:    %15s  Blocks: %12s\n",
+            c_byte, c_block);
+    }
+
+    out_term();
+    return out_status(c > 0  and  omitted == 0 ? RC_OKAY : RC_ERR);
+}
+
+/* End vfind.c */